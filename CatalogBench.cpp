@@ -0,0 +1,692 @@
+//=========================================================================//
+// Name        : CatalogBench.cpp                                          //
+// Author      : GCZ79                                                     //
+// Version     : 1.0                                                       //
+// Date        : 02/21/2026                                                //
+// Description : Benchmarks and synthetic catalogs for the course catalog  //
+//=========================================================================//
+
+#include "CourseCatalog.h"
+
+#include <chrono>    // steady_clock - benchmark timings
+#include <filesystem> // temp_directory_path() - scratch files for the benchmark suite
+#include <fstream>   // ofstream - writes generated catalogs
+#include <sstream>   // stringstream - parses comma-separated lists
+#include <thread>    // hardware_concurrency() - reported with the benchmark results
+
+//============//
+// Benchmarks //
+//============//
+
+/**
+ * Batch-plan synthetic students over a catalog and report students planned per second
+ * Each student has a random prefix of the topological order completed (so the records
+ * are consistent), and gets an incremental update plus a full semester plan.
+ */
+void benchmarkPlanner(const string& filename) {
+    BinarySearchTree tree;
+    loadCourses(filename, &tree);
+    const PrerequisiteGraph* graph = tree.Graph();
+    if (tree.Size() == 0 || graph == nullptr) {
+        return;
+    }
+    tree.Freeze();
+
+    const size_t STUDENTS = 2000;
+    const vector<uint32_t>& order = graph->topologicalOrder();
+    SemesterPlanner planner(*graph);
+    vector<uint32_t> courses;
+    vector<uint32_t> semesterStarts;
+    unsigned seed = 12345;          // Fixed sequence so runs are comparable
+    size_t semesters = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t student = 0; student < STUDENTS; student++) {
+        seed = seed * 1103515245 + 12345;
+        size_t taken = order.empty() ? 0 : (seed >> 8) % order.size();
+        planner.reset();
+        for (size_t i = 0; i < taken; i++) {
+            planner.complete(order[i]);
+        }
+        planner.plan(courses, semesterStarts, 5);
+        semesters += semesterStarts.size() - 1;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Semester planning (" << graph->size() << " courses, "
+        << graph->prerequisiteCycles().size() << " cycles)" << endl;
+    cout << "  " << STUDENTS << " students, " << semesters / STUDENTS << " semesters on average, "
+        << static_cast<long long>(STUDENTS / elapsed.count()) << " students/sec" << endl;
+}
+
+/**
+ * Compare tokenizer throughput on a CSV file: split() vs splitView() vs each SIMD kernel set
+ * Every variant tokenizes the whole file several times; the best run is reported in MB/s
+ */
+void benchmarkTokenizers(const string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cout << "Error: Could not open file " << filename << endl;
+        return;
+    }
+    string_view text = file.view();
+    const int RUNS = 5;
+
+    // Time one tokenizer; it returns a token count so the work cannot be optimized away
+    auto measure = [&](const string& label, auto tokenize) {
+        double bestSeconds = 1e30;
+        size_t tokenCount = 0;
+        for (int run = 0; run < RUNS; run++) {
+            auto start = chrono::steady_clock::now();
+            tokenCount = tokenize();
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            bestSeconds = min(bestSeconds, elapsed.count());
+        }
+        double megabytes = text.size() / (1024.0 * 1024.0);
+        cout << "  " << label << ": " << tokenCount << " tokens, "
+            << (bestSeconds > 0 ? megabytes / bestSeconds : 0.0) << " MB/s" << endl;
+    };
+
+    cout << "Tokenizer throughput for " << filename << " (" << text.size() << " bytes)" << endl;
+
+    // Original path: one string per line, one istringstream and vector<string> per split()
+    measure("split (istringstream)", [&]() {
+        size_t tokenCount = 0;
+        size_t position = 0;
+        while (position < text.size()) {
+            size_t lineEnd = min(text.find('\n', position), text.size());
+            string line(text.substr(position, lineEnd - position));
+            tokenCount += line.empty() ? 0 : split(line, ',').size();
+            position = lineEnd + 1;
+        }
+        return tokenCount;
+    });
+
+    // Scalar string_view tokenizer
+    measure("splitView (scalar)", [&]() {
+        size_t tokenCount = 0;
+        size_t position = 0;
+        vector<string_view> tokens;
+        while (position < text.size()) {
+            size_t lineEnd = min(text.find('\n', position), text.size());
+            splitView(text.substr(position, lineEnd - position), ',', tokens);
+            tokenCount += tokens.size();
+            position = lineEnd + 1;
+        }
+        return tokenCount;
+    });
+
+    // Bitmask scanner with each kernel set this CPU supports
+    for (const SimdKernels* kernels : availableKernels()) {
+        measure(string("scanner (") + kernels->name + ")", [&]() {
+            size_t tokenCount = 0;
+            forEachCsvLine(text, *kernels, [&](int, const vector<string_view>& tokens) {
+                tokenCount += tokens.size();
+            });
+            return tokenCount;
+        });
+    }
+    cout << "Selected at runtime: " << bestKernels().name << endl;
+}
+
+/**
+ * Compare lookup throughput of the pointer tree and the frozen index on a CSV catalog
+ * Every course number is looked up in a shuffled order (hits), then the same keys with a
+ * suffix appended (misses); lookups per second are reported for both layouts
+ */
+void benchmarkLookups(const string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cout << "Error: Could not open file " << filename << endl;
+        return;
+    }
+
+    // Collect the keys straight from the file
+    ParsedCatalog catalog;
+    parseCourseLinesParallel(file.view(), catalog);
+    vector<string> hits;
+    for (const CourseRecord& record : catalog.records) {
+        hits.emplace_back(record.courseNumber);
+    }
+    vector<string> misses;
+    for (const string& key : hits) {
+        misses.push_back(key + "#");
+    }
+    unsigned seed = 12345;          // Fixed shuffle so runs are comparable
+    for (size_t i = hits.size(); i > 1; i--) {
+        seed = seed * 1103515245 + 12345;
+        swap(hits[i - 1], hits[seed % i]);
+        swap(misses[i - 1], misses[seed % i]);
+    }
+
+    BinarySearchTree tree;
+    loadCourses(filename, &tree);
+    if (tree.Size() == 0) {
+        return;
+    }
+
+    auto measure = [&](const string& label, const vector<string>& keys) {
+        const int RUNS = 3;
+        double bestSeconds = 1e30;
+        size_t found = 0;
+        for (int run = 0; run < RUNS; run++) {
+            found = 0;
+            auto start = chrono::steady_clock::now();
+            for (const string& key : keys) {
+                found += tree.Contains(key) ? 1 : 0;
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            bestSeconds = min(bestSeconds, elapsed.count());
+        }
+        cout << "  " << label << ": " << found << "/" << keys.size() << " found, "
+            << static_cast<long long>(keys.size() / bestSeconds) << " lookups/sec" << endl;
+    };
+
+    // Batches of transcript size: N Search() calls (each an owning copy) vs one FindMany()
+    const size_t BATCH = 256;
+    vector<string_view> hitViews(hits.begin(), hits.end());
+    auto measureBatch = [&](const string& label) {
+        const int RUNS = 3;
+        double searchSeconds = 1e30;
+        double batchSeconds = 1e30;
+        size_t found = 0;
+        for (int run = 0; run < RUNS; run++) {
+            auto start = chrono::steady_clock::now();
+            for (const string& key : hits) {
+                tree.Search(key);
+            }
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            searchSeconds = min(searchSeconds, elapsed.count());
+
+            found = 0;
+            start = chrono::steady_clock::now();
+            for (size_t first = 0; first < hitViews.size(); first += BATCH) {
+                vector<CourseRef> batch = tree.FindMany(hitViews.data() + first, min(BATCH, hitViews.size() - first));
+                found += static_cast<size_t>(count_if(batch.begin(), batch.end(),
+                    [](const CourseRef& course) { return static_cast<bool>(course); }));
+            }
+            elapsed = chrono::steady_clock::now() - start;
+            batchSeconds = min(batchSeconds, elapsed.count());
+        }
+        cout << "  " << label << ": " << found << "/" << hits.size() << " found, "
+            << static_cast<long long>(hits.size() / batchSeconds) << " lookups/sec in batches of " << BATCH
+            << " (" << static_cast<long long>(hits.size() / searchSeconds) << " with one Search() each)" << endl;
+    };
+
+    cout << "Lookup throughput (" << tree.Size() << " courses)" << endl;
+    measure("pointer tree, hits  ", hits);
+    measure("pointer tree, misses", misses);
+    measureBatch("pointer tree, batch ");
+    tree.Freeze();
+    measure("frozen index, hits  ", hits);
+    measure("frozen index, misses", misses);
+    measureBatch("frozen index, batch ");
+}
+
+//=================//
+// Benchmark Suite //
+//=================//
+
+/**
+ * Order in which synthetic courses are listed (and inserted)
+ */
+enum SyntheticOrder {
+    SORTED_ORDER,        // Ascending course numbers - a plain BST degenerates into a list
+    RANDOM_ORDER,        // Shuffled - the textbook average case
+    ADVERSARIAL_ORDER    // Zig-zag from both ends under one long shared prefix: deep plain
+                         // BSTs, double rotations in AVL mode, long string compares
+};
+
+static const char* syntheticOrderName(SyntheticOrder order) {
+    return order == SORTED_ORDER ? "sorted" : order == RANDOM_ORDER ? "random" : "adversarial";
+}
+
+/**
+ * Generate an ABCU-style catalog of count courses
+ * Course numbers look like "MATH1042"; each course gets up to fanout prerequisites drawn
+ * from courses that sort before it, so the catalog is always valid and acyclic. The seed
+ * fixes the output, so runs with the same parameters are comparable.
+ */
+vector<Course> makeSyntheticCatalog(size_t count, SyntheticOrder order, size_t fanout, unsigned seed = 12345) {
+    static const char* const DEPARTMENTS[] = { "ACCT", "BIOL", "CHEM", "CSCI", "ECON", "ENGL",
+        "HIST", "MATH", "PHYS", "PSYC", "SOCI", "STAT" };
+    static const char* const SUBJECTS[] = { "Algorithms", "Analysis", "Biology", "Calculus",
+        "Chemistry", "Data", "Design", "Economics", "Ethics", "Finance", "Genetics", "History",
+        "Logic", "Networks", "Optics", "Programming", "Statistics", "Structures", "Systems", "Theory" };
+    static const char* const LEVELS[] = { "Introduction to", "Topics in", "Advanced", "Applied",
+        "Foundations of", "Seminar in" };
+    const size_t DEPARTMENT_COUNT = sizeof(DEPARTMENTS) / sizeof(DEPARTMENTS[0]);
+    const size_t SUBJECT_COUNT = sizeof(SUBJECTS) / sizeof(SUBJECTS[0]);
+    const size_t LEVEL_COUNT = sizeof(LEVELS) / sizeof(LEVELS[0]);
+
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<size_t>(seed >> 8);
+    };
+
+    // Course numbers in ascending order (serials are zero-padded, so string order matches)
+    vector<Course> courses(count);
+    size_t perDepartment = order == ADVERSARIAL_ORDER ? count : (count + DEPARTMENT_COUNT - 1) / DEPARTMENT_COUNT;
+    size_t digits = max<size_t>(3, to_string(perDepartment).size());
+    for (size_t i = 0; i < count; i++) {
+        string serial = to_string(i % perDepartment);
+        serial.insert(0, digits - serial.size(), '0');
+        courses[i].courseNumber = order == ADVERSARIAL_ORDER ? "INTERDISCIPLINARYSTUDIES" + serial
+            : DEPARTMENTS[i / perDepartment] + serial;  // Department-major: serials restart per department
+        courses[i].courseName = string(LEVELS[next() % LEVEL_COUNT]) + " " + SUBJECTS[next() % SUBJECT_COUNT]
+            + " " + to_string(i % 500);
+        size_t wanted = min(fanout, i);
+        for (size_t j = 0; j < wanted; j++) {
+            // Mostly nearby courses (realistic chains), sometimes anything earlier
+            size_t window = next() % 4 == 0 ? i : min<size_t>(i, 64);
+            const string& prerequisite = courses[i - 1 - next() % window].courseNumber;
+            if (std::find(courses[i].prerequisites.begin(), courses[i].prerequisites.end(), prerequisite)
+                == courses[i].prerequisites.end()) {
+                courses[i].prerequisites.push_back(prerequisite);
+            }
+        }
+    }
+
+    if (order == RANDOM_ORDER) {
+        for (size_t i = count; i > 1; i--) {
+            swap(courses[i - 1], courses[next() % i]);
+        }
+    }
+    else if (order == ADVERSARIAL_ORDER) {
+        vector<Course> zigzag;
+        zigzag.reserve(count);
+        for (size_t low = 0, high = count; low < high;) {
+            zigzag.push_back(move(courses[low++]));
+            if (low < high) {
+                zigzag.push_back(move(courses[--high]));
+            }
+        }
+        courses.swap(zigzag);
+    }
+    return courses;
+}
+
+/**
+ * Write courses as an ABCU CSV file (number,name,prerequisites...)
+ */
+bool writeCatalogCsv(const string& filename, const vector<Course>& courses) {
+    ofstream out(filename, ios::binary);
+    if (!out) {
+        return false;
+    }
+    string line;
+    for (const Course& course : courses) {
+        line = course.courseNumber + "," + course.courseName;
+        for (const string& prerequisite : course.prerequisites) {
+            line += "," + prerequisite;
+        }
+        line += '\n';
+        out.write(line.data(), static_cast<streamsize>(line.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+/**
+ * Stream buffer that discards everything - a sink for output-bound benchmarks
+ */
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c == EOF ? 0 : c; }
+    streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+/**
+ * Run one synthetic catalog configuration and write its results as a JSON object
+ * Each timing is the best of a few runs. Lookups use a fixed shuffle of the keys; misses
+ * are real keys with a suffix, so they fail at the last comparison. The textbook
+ * alternatives from the README are measured next to the tree: an unsorted vector with
+ * linear search, a sorted vector with binary search, and a hash table. The plain
+ * (unbalanced) BST and the linear vector are skipped (null) where they would take
+ * quadratic time. Tree lookups go through Contains() (the allocation-free Find() path);
+ * "bst_search" times the owning-copy Search() API on the same tree.
+ */
+void benchmarkConfiguration(size_t count, SyntheticOrder order, size_t fanout, JsonWriter& json) {
+    const int RUNS = 3;
+    const size_t MAX_LOOKUPS = 200000;           // Keys per lookup measurement
+    const size_t LINEAR_MAX_COURSES = 100000;    // Vector linear search beyond this: skipped
+    const size_t LINEAR_LOOKUPS = 1000;          // Keys for O(n) lookups (linear vector, degenerate BST)
+    const size_t PLAIN_BST_MAX_COURSES = 10000;  // Plain BST on non-random input beyond this: skipped
+
+    using Clock = chrono::steady_clock;
+    auto seconds = [](Clock::time_point start) {
+        return chrono::duration<double>(Clock::now() - start).count();
+    };
+    auto perSecond = [](size_t operations, double elapsed) {
+        return elapsed > 0 ? static_cast<long long>(operations / elapsed) : 0LL;
+    };
+
+    vector<Course> courses = makeSyntheticCatalog(count, order, fanout);
+    string csvFile = (filesystem::temp_directory_path() / ("abcu_bench_" + to_string(count) + ".csv")).string();
+    if (!writeCatalogCsv(csvFile, courses)) {
+        cerr << "Error: Could not write " << csvFile << endl;
+        return;
+    }
+
+    // Keys in a fixed shuffled order, hits and misses
+    vector<string> hits;
+    unsigned seed = 54321;
+    for (size_t i = 0; i < min(count, MAX_LOOKUPS); i++) {
+        seed = seed * 1103515245 + 12345;
+        hits.push_back(courses[(seed >> 8) % count].courseNumber);
+    }
+    vector<string> misses;
+    for (const string& key : hits) {
+        misses.push_back(key + "X");
+    }
+
+    NullBuffer nullBuffer;
+    streambuf* console = cout.rdbuf(&nullBuffer); // loadCourses and PrintCourseList talk to cout
+
+    // loadCourses: map, parse, validate, build, plus the graph and name index
+    double loadSeconds = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        BinarySearchTree tree;
+        Clock::time_point start = Clock::now();
+        loadCourses(csvFile, &tree);
+        loadSeconds = min(loadSeconds, seconds(start));
+    }
+
+    // Inserts, one course at a time in file order
+    bool plainFeasible = order == RANDOM_ORDER || count <= PLAIN_BST_MAX_COURSES;
+    double insertBalanced = 1e30, insertPlain = 1e30, insertSorted = 1e30, insertHash = 1e30;
+    BinarySearchTree balancedTree;
+    BinarySearchTree plainTree(false);
+    vector<Course> sortedVector;
+    unordered_map<string, Course> hashTable;
+    for (int run = 0; run < RUNS; run++) {
+        BinarySearchTree tree;
+        Clock::time_point start = Clock::now();
+        for (const Course& course : courses) {
+            tree.Insert(course);
+        }
+        insertBalanced = min(insertBalanced, seconds(start));
+
+        if (plainFeasible) {
+            BinarySearchTree plain(false);
+            start = Clock::now();
+            for (const Course& course : courses) {
+                plain.Insert(course);
+            }
+            insertPlain = min(insertPlain, seconds(start));
+        }
+
+        start = Clock::now();                    // Vector: append everything, sort once
+        vector<Course> sorted(courses.begin(), courses.end());
+        sort(sorted.begin(), sorted.end(), [](const Course& a, const Course& b) {
+            return a.courseNumber < b.courseNumber;
+        });
+        insertSorted = min(insertSorted, seconds(start));
+
+        start = Clock::now();
+        unordered_map<string, Course> table;
+        for (const Course& course : courses) {
+            table.emplace(course.courseNumber, course);
+        }
+        insertHash = min(insertHash, seconds(start));
+
+        if (run == RUNS - 1) {
+            sortedVector.swap(sorted);
+            hashTable.swap(table);
+        }
+    }
+    for (const Course& course : courses) {
+        balancedTree.Insert(course);
+        if (plainFeasible) {
+            plainTree.Insert(course);
+        }
+    }
+    int balancedDepth = balancedTree.MaxDepth();
+    int plainDepth = plainFeasible ? plainTree.MaxDepth() : 0;
+
+    // Lookups per second for one structure over a key list
+    auto measure = [&](const vector<string>& keys, size_t limit, auto&& lookup) {
+        size_t used = min(limit, keys.size());
+        double best = 1e30;
+        for (int run = 0; run < RUNS; run++) {
+            size_t found = 0;
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < used; i++) {
+                found += lookup(keys[i]) ? 1 : 0;
+            }
+            best = min(best, seconds(start));
+            if (found > used) {
+                best = 0;                        // Unreachable - keeps found observable
+            }
+        }
+        return perSecond(used, best);
+    };
+    auto treeLookup = [](BinarySearchTree& tree) {
+        return [&tree](const string& key) { return tree.Contains(key); };
+    };
+    auto searchLookup = [&](const string& key) { return !balancedTree.Search(key).courseNumber.empty(); };
+    auto linearLookup = [&](const string& key) {
+        for (const Course& course : courses) {
+            if (course.courseNumber == key) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto sortedLookup = [&](const string& key) {
+        auto found = lower_bound(sortedVector.begin(), sortedVector.end(), key,
+            [](const Course& course, const string& number) { return course.courseNumber < number; });
+        return found != sortedVector.end() && found->courseNumber == key;
+    };
+    auto hashLookup = [&](const string& key) { return hashTable.find(key) != hashTable.end(); };
+
+    struct LookupRates { long long balanced, search, plain, frozen, linear, sorted, hash; };
+    LookupRates rates[2];
+    const vector<string>* keyLists[2] = { &hits, &misses };
+    BinarySearchTree frozenTree;
+    for (const Course& course : courses) {
+        frozenTree.Insert(course);
+    }
+    frozenTree.Freeze();
+    for (int kind = 0; kind < 2; kind++) {
+        const vector<string>& keys = *keyLists[kind];
+        rates[kind].balanced = measure(keys, MAX_LOOKUPS, treeLookup(balancedTree));
+        rates[kind].search = measure(keys, MAX_LOOKUPS, searchLookup);
+        rates[kind].plain = plainFeasible ? measure(keys, order == RANDOM_ORDER ? MAX_LOOKUPS : LINEAR_LOOKUPS,
+            treeLookup(plainTree)) : 0;
+        rates[kind].frozen = measure(keys, MAX_LOOKUPS, treeLookup(frozenTree));
+        rates[kind].linear = count <= LINEAR_MAX_COURSES ? measure(keys, LINEAR_LOOKUPS, linearLookup) : 0;
+        rates[kind].sorted = measure(keys, MAX_LOOKUPS, sortedLookup);
+        rates[kind].hash = measure(keys, MAX_LOOKUPS, hashLookup);
+    }
+
+    // PrintCourseList into the null sink: traversal plus formatting
+    double printSeconds = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        Clock::time_point start = Clock::now();
+        balancedTree.PrintCourseList();
+        printSeconds = min(printSeconds, seconds(start));
+    }
+
+    // Size(): O(1) - the volatile pointer keeps the call inside the loop
+    const size_t SIZE_CALLS = 10000000;
+    BinarySearchTree* volatile sizeTarget = &balancedTree;
+    long long sizeTotal = 0;
+    Clock::time_point sizeStart = Clock::now();
+    for (size_t i = 0; i < SIZE_CALLS; i++) {
+        sizeTotal += sizeTarget->Size();
+    }
+    double sizeSeconds = seconds(sizeStart);
+
+    cout.rdbuf(console);
+    filesystem::remove(csvFile);
+
+    auto optional = [&](bool measured, long long number) -> JsonWriter& {
+        return measured ? json.value(number) : json.null();
+    };
+    json.beginObject();
+    json.key("courses").value(count);
+    json.key("order").value(syntheticOrderName(order));
+    json.key("fanout").value(fanout);
+    json.key("load_seconds").value(loadSeconds);
+    json.key("load_courses_per_sec").value(perSecond(count, loadSeconds));
+    json.key("insert_per_sec").beginObject();
+    json.key("bst").value(perSecond(count, insertBalanced));
+    json.key("plain_bst");
+    optional(plainFeasible, perSecond(count, insertPlain));
+    json.key("sorted_vector").value(perSecond(count, insertSorted));
+    json.key("hash_table").value(perSecond(count, insertHash));
+    json.endObject();
+    json.key("depth").beginObject();
+    json.key("bst").value(balancedDepth);
+    json.key("plain_bst");
+    optional(plainFeasible, plainDepth);
+    json.endObject();
+    const char* lookupKeys[2] = { "search_hit_per_sec", "search_miss_per_sec" };
+    for (int kind = 0; kind < 2; kind++) {
+        json.key(lookupKeys[kind]).beginObject();
+        json.key("bst").value(rates[kind].balanced);
+        json.key("bst_search").value(rates[kind].search);
+        json.key("plain_bst");
+        optional(plainFeasible, rates[kind].plain);
+        json.key("frozen").value(rates[kind].frozen);
+        json.key("linear_vector");
+        optional(count <= LINEAR_MAX_COURSES, rates[kind].linear);
+        json.key("sorted_vector").value(rates[kind].sorted);
+        json.key("hash_table").value(rates[kind].hash);
+        json.endObject();
+    }
+    json.key("print_list_seconds").value(printSeconds);
+    json.key("size_ns").value(sizeSeconds * 1e9 / SIZE_CALLS);
+    json.key("size_checksum").value(sizeTotal);
+    json.endObject();
+}
+
+/**
+ * Split a comma-separated command-line list
+ */
+static vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream stream(list);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * Parse an order name; false if it is not one
+ */
+static bool parseSyntheticOrder(const string& name, SyntheticOrder& order) {
+    for (SyntheticOrder candidate : { SORTED_ORDER, RANDOM_ORDER, ADVERSARIAL_ORDER }) {
+        if (name == syntheticOrderName(candidate)) {
+            order = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Benchmark every combination of sizes x orders x fan-outs and print one JSON document
+ * Lists are comma-separated ("1000,100000", "sorted,random,adversarial", "0,2,8");
+ * progress goes to stderr so stdout stays valid JSON.
+ */
+void runBenchmarkSuite(const string& sizeList, const string& orderList, const string& fanoutList) {
+    vector<size_t> sizes;
+    for (const string& item : splitList(sizeList)) {
+        double size = atof(item.c_str());        // atof so "1e6" works
+        if (size < 1 || size > 1e8) {
+            cerr << "Error: Invalid size " << item << endl;
+            return;
+        }
+        sizes.push_back(static_cast<size_t>(size));
+    }
+    vector<SyntheticOrder> orders;
+    for (const string& item : splitList(orderList)) {
+        SyntheticOrder order;
+        if (!parseSyntheticOrder(item, order)) {
+            cerr << "Error: Invalid order " << item << " (sorted, random or adversarial)" << endl;
+            return;
+        }
+        orders.push_back(order);
+    }
+    vector<size_t> fanouts;
+    for (const string& item : splitList(fanoutList)) {
+        fanouts.push_back(static_cast<size_t>(max(0, atoi(item.c_str()))));
+    }
+
+    JsonWriter json(cout);
+    json.beginObject();
+    json.key("benchmark").value("abcu-catalog");
+    json.key("hardware_threads").value(static_cast<int>(thread::hardware_concurrency()));
+    json.key("results").beginArray();
+    for (size_t size : sizes) {
+        for (SyntheticOrder order : orders) {
+            for (size_t fanout : fanouts) {
+                cerr << "Benchmarking " << size << " courses, " << syntheticOrderName(order)
+                    << " order, fan-out " << fanout << "..." << endl;
+                benchmarkConfiguration(size, order, fanout, json);
+            }
+        }
+    }
+    json.endArray();
+    json.endObject();
+    cout << endl;
+}
+
+/**
+ * Write a synthetic catalog to a CSV file (for the file-based benchmarks or manual tests)
+ */
+void generateCatalog(const string& filename, const string& sizeText, const string& orderName, const string& fanoutText) {
+    double size = atof(sizeText.c_str());
+    SyntheticOrder order;
+    if (size < 1 || size > 1e8 || !parseSyntheticOrder(orderName, order)) {
+        cout << "Error: Expected a size (1-1e8) and an order (sorted, random or adversarial)" << endl;
+        return;
+    }
+    vector<Course> courses = makeSyntheticCatalog(static_cast<size_t>(size), order,
+        static_cast<size_t>(max(0, atoi(fanoutText.c_str()))));
+    if (!writeCatalogCsv(filename, courses)) {
+        cout << "Error: Could not write " << filename << endl;
+        return;
+    }
+    cout << "Wrote " << courses.size() << " courses to " << filename << endl;
+}
+
+//===============//
+// Main Function //
+//===============//
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && string(argv[1]) == "--bench-tokenizer") {
+        benchmarkTokenizers(argv[2]); // Tokenizer throughput comparison on a CSV file
+        return 0;
+    }
+    if (argc == 3 && string(argv[1]) == "--bench-lookup") {
+        benchmarkLookups(argv[2]);    // Pointer tree vs frozen index lookups/sec
+        return 0;
+    }
+    if (argc == 3 && string(argv[1]) == "--bench-planner") {
+        benchmarkPlanner(argv[2]);    // Students batch-planned per second
+        return 0;
+    }
+    if (argc >= 2 && argc <= 5 && string(argv[1]) == "--bench-suite") {
+        runBenchmarkSuite(argc > 2 ? argv[2] : "1000,10000,100000",       // Sizes
+            argc > 3 ? argv[3] : "sorted,random,adversarial",               // Key orders
+            argc > 4 ? argv[4] : "0,2,8");                                  // Prerequisite fan-outs
+        return 0;
+    }
+    if (argc >= 4 && argc <= 6 && string(argv[1]) == "--generate") {
+        generateCatalog(argv[2], argv[3], argc > 4 ? argv[4] : "random", argc > 5 ? argv[5] : "2");
+        return 0;
+    }
+    cout << "Usage: " << argv[0] << " --bench-tokenizer FILE" << endl;
+    cout << "       " << argv[0] << " --bench-lookup FILE" << endl;
+    cout << "       " << argv[0] << " --bench-planner FILE" << endl;
+    cout << "       " << argv[0] << " --bench-suite [SIZES] [ORDERS] [FANOUTS]" << endl;
+    cout << "       " << argv[0] << " --generate FILE SIZE [ORDER] [FANOUT]" << endl;
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,796 @@
+//=========================================================================//
+// Name        : CatalogDaemon.cpp                                         //
+// Author      : GCZ79                                                     //
+// Version     : 1.0                                                       //
+// Date        : 02/21/2026                                                //
+// Description : Catalog query daemon and load generator (Unix sockets)    //
+//=========================================================================//
+
+#include "CourseCatalog.h"
+
+#include <chrono>    // steady_clock - load test duration and latencies
+#include <condition_variable> // condition_variable - daemon worker pool job queue
+#include <cstdlib>   // atoi()/atof() - command-line arguments
+#include <deque>     // deque - daemon worker pool job queue
+#include <mutex>     // mutex - daemon worker pool job queue
+#include <sstream>   // ostringstream - JSON statistics response
+#include <thread>    // thread - daemon workers and load generator connections
+
+#ifdef __linux__
+#include <csignal>       // sigset_t - SIGINT/SIGTERM delivered to the daemon's event loop
+#include <sys/epoll.h>   // epoll_wait() - daemon event loop
+#include <sys/eventfd.h> // eventfd() - workers wake the daemon's event loop
+#include <sys/signalfd.h> // signalfd() - clean daemon shutdown
+#include <sys/socket.h>  // socket()/accept4()/send() - Unix domain socket protocol
+#include <sys/un.h>      // sockaddr_un - Unix domain socket address
+#include <unistd.h>      // close()/read()/write()
+#endif
+
+//==============//
+// Query Daemon //
+//==============//
+
+/**
+ * Append one course as a response line: number, name and prerequisites, tab-separated
+ */
+static void appendCourseLine(const CourseRef& course, string& response) {
+    response.append(course.number()).push_back('\t');
+    response.append(course.name()).push_back('\t');
+    for (size_t i = 0; i < course.prerequisiteCount(); i++) {
+        if (i > 0) {
+            response.push_back(',');
+        }
+        response.append(course.prerequisite(i));
+    }
+    response.push_back('\n');
+}
+
+/**
+ * Answer one request line of the query protocol, replacing response
+ * Every response is a header "OK <n>\n" followed by exactly n lines, or a single
+ * "ERR <reason>\n" line, so clients can frame replies without knowing the command.
+ *
+ *   PING                        OK 1, "PONG"
+ *   FIND <course>               OK 1 with the course line, or OK 0 if it does not exist
+ *   BATCH <course> <course>...  One line per key in request order ("-" if not found)
+ *   LIST [prefix]               Course lines in alphanumeric order (optionally by prefix)
+ *   PREREQS <course>            One line with the full prerequisite chain, comma-separated
+ *   REQUIRES <course> <prereq>  One line, "YES" or "NO"
+ *   SEARCH <words>              Course lines of the best course name matches
+ *   STATS                       One line of JSON (see writeStatisticsJson)
+ *
+ * The tree is only read, so any number of threads may answer queries at once.
+ */
+void answerQuery(const BinarySearchTree& catalog, string_view request, string& response) {
+    response.clear();
+    vector<string_view> words;
+    size_t position = 0;
+    while (position < request.size()) {     // Split on spaces and tabs
+        size_t start = request.find_first_not_of(" \t\r", position);
+        if (start == string_view::npos) {
+            break;
+        }
+        size_t end = request.find_first_of(" \t\r", start);
+        end = end == string_view::npos ? request.size() : end;
+        words.push_back(request.substr(start, end - start));
+        position = end;
+    }
+    if (words.empty()) {
+        response = "ERR empty request\n";
+        return;
+    }
+    FoldedKey command(words[0]);
+    string_view name = command.view();
+
+    if (name == "PING") {
+        response = "OK 1\nPONG\n";
+    }
+    else if (name == "FIND" && words.size() == 2) {
+        CourseRef course = catalog.Find(words[1]);
+        response = course ? "OK 1\n" : "OK 0\n";
+        if (course) {
+            appendCourseLine(course, response);
+        }
+    }
+    else if (name == "BATCH" && words.size() >= 2) {
+        vector<CourseRef> courses = catalog.FindMany(words.data() + 1, words.size() - 1);
+        response.append("OK ").append(to_string(courses.size())).push_back('\n');
+        for (const CourseRef& course : courses) {
+            if (course) {
+                appendCourseLine(course, response);
+            }
+            else {
+                response.append("-\n");
+            }
+        }
+    }
+    else if (name == "LIST" && words.size() <= 2) {
+        CourseRange range = words.size() == 2 ? catalog.Prefix(words[1]) : CourseRange{ catalog.begin(), catalog.end() };
+        string lines;
+        size_t count = 0;
+        for (CourseRef course : range) {
+            appendCourseLine(course, lines);
+            count++;
+        }
+        response.append("OK ").append(to_string(count)).push_back('\n');
+        response.append(lines);
+    }
+    else if ((name == "PREREQS" && words.size() == 2) || (name == "REQUIRES" && words.size() == 3)) {
+        const PrerequisiteGraph* graph = catalog.Graph();
+        FoldedKey course(words[1]);
+        long id = graph ? graph->find(course.view()) : -1;
+        if (id < 0) {
+            response = "OK 0\n";
+            return;
+        }
+        response = "OK 1\n";
+        if (name == "PREREQS") {
+            bool first = true;
+            graph->forEachPrerequisite(static_cast<uint32_t>(id), [&](uint32_t prerequisite) {
+                if (!first) {
+                    response.push_back(',');
+                }
+                response.append(graph->number(prerequisite));
+                first = false;
+            });
+            response.push_back('\n');
+        }
+        else {
+            FoldedKey prerequisiteKey(words[2]);
+            long prerequisite = graph->find(prerequisiteKey.view());
+            bool required = prerequisite >= 0 &&
+                graph->isRequired(static_cast<uint32_t>(id), static_cast<uint32_t>(prerequisite));
+            response.append(required ? "YES\n" : "NO\n");
+        }
+    }
+    else if (name == "STATS" && words.size() == 1) {
+        ostringstream json;
+        writeStatisticsJson(&catalog, json);
+        response.append("OK 1\n").append(json.str()).push_back('\n');
+    }
+    else if (name == "SEARCH" && words.size() >= 2) {
+        size_t textStart = words[1].data() - request.data();
+        vector<NameMatch> matches = catalog.SearchNames(request.substr(textStart));
+        response.append("OK ").append(to_string(matches.size())).push_back('\n');
+        for (const NameMatch& match : matches) {
+            appendCourseLine(catalog.Select(match.course), response);
+        }
+    }
+    else {
+        response = "ERR unknown command or wrong number of arguments\n";
+    }
+}
+
+#ifdef __linux__
+/**
+ * Query daemon: one epoll thread owns every socket; a pool of worker threads answers
+ * the requests. Each connection has at most one request with the workers at a time, so
+ * replies come back in request order even when a client pipelines several lines. Workers
+ * hand finished replies back through a queue and wake the event loop with an eventfd.
+ * SIGINT/SIGTERM arrive through a signalfd and stop the loop cleanly. SIGHUP reloads the
+ * catalog on a background thread and publishes it while the workers keep answering.
+ */
+class QueryServer {
+private:
+    struct Connection {
+        int fd;
+        string input;            // Bytes received but not yet handed to a worker
+        string output;           // Reply bytes not yet written
+        bool busy;               // A request from this connection is with the workers
+        bool closing;            // Peer closed its side - close once everything is answered
+        bool writing;            // Registered for EPOLLOUT
+    };
+    struct Job {
+        uint64_t connection;     // Connection ID (fds are reused, IDs are not)
+        string request;
+        string response;
+    };
+
+    static constexpr uint64_t LISTENER = 0;         // epoll data for the listening socket
+    static constexpr uint64_t WAKEUP = 1;           // ... the workers' eventfd
+    static constexpr uint64_t SIGNALS = 2;          // ... the signalfd
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+
+    CatalogHandle& catalog;
+    string catalogFile;          // Reloaded on SIGHUP
+    int listener;
+    int epoll;
+    int wakeup;
+    int signals;
+    uint64_t nextId;
+    unordered_map<uint64_t, Connection> connections;
+
+    mutex queueLock;                             // Guards jobs, done and stopping
+    condition_variable jobReady;
+    deque<Job> jobs;
+    vector<Job> done;
+    bool stopping;
+    vector<thread> workers;
+    uint64_t answered;
+    thread reloader;
+    atomic<bool> reloading;
+
+    void reload();
+
+    void workerLoop();
+    void accept();
+    void receive(uint64_t id);
+    void dispatch(uint64_t id, Connection& connection);
+    void flush(uint64_t id, Connection& connection);
+    void watch(uint64_t id, const Connection& connection);
+    void collect();
+    void drop(uint64_t id);
+
+public:
+    QueryServer(CatalogHandle& published, const string& filename) : catalog(published), catalogFile(filename),
+        listener(-1), epoll(-1), wakeup(-1), signals(-1), nextId(SIGNALS + 1), stopping(false), answered(0),
+        reloading(false) {}
+    ~QueryServer();
+
+    bool listen(const string& socketPath);        // Bind the socket and set up the event loop
+    void run(unsigned workerCount);               // Serve until SIGINT/SIGTERM
+};
+
+QueryServer::~QueryServer() {
+    for (auto& entry : connections) {
+        close(entry.second.fd);
+    }
+    for (int fd : { listener, epoll, wakeup, signals }) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+/**
+ * Create the listening socket (replacing a stale socket file) and the epoll set
+ */
+bool QueryServer::listen(const string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cout << "Error: Socket path too long: " << socketPath << endl;
+        return false;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    unlink(socketPath.c_str());
+
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listener, SOMAXCONN) != 0) {
+        cout << "Error: Could not listen on " << socketPath << ": " << strerror(errno) << endl;
+        return false;
+    }
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);   // Before any worker starts, so they inherit it
+    signals = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (signals < 0 || wakeup < 0 || epoll < 0) {
+        cout << "Error: Could not set up the event loop: " << strerror(errno) << endl;
+        return false;
+    }
+    for (auto source : { make_pair(listener, LISTENER), make_pair(wakeup, WAKEUP), make_pair(signals, SIGNALS) }) {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = source.second;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, source.first, &event);
+    }
+    return true;
+}
+
+/**
+ * Event loop: accept, read, hand requests to workers, write replies
+ */
+void QueryServer::run(unsigned workerCount) {
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers.emplace_back(&QueryServer::workerLoop, this);
+    }
+
+    const int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    bool running = true;
+    while (running) {
+        int ready = epoll_wait(epoll, events, MAX_EVENTS, -1);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTENER) {
+                accept();
+            }
+            else if (id == WAKEUP) {
+                collect();
+            }
+            else if (id == SIGNALS) {
+                signalfd_siginfo info;
+                while (read(signals, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+                    if (info.ssi_signo != SIGHUP) {
+                        running = false;
+                    }
+                    else if (!reloading.exchange(true)) {
+                        if (reloader.joinable()) {
+                            reloader.join();     // Previous reload is done - reloading was clear
+                        }
+                        reloader = thread(&QueryServer::reload, this);
+                    }
+                }
+            }
+            else {
+                auto found = connections.find(id);
+                if (found == connections.end()) {
+                    continue;                    // Dropped earlier in this batch of events
+                }
+                if (found->second.closing && (events[i].events & (EPOLLERR | EPOLLHUP))) {
+                    drop(id);                    // Fully gone: pending replies cannot be delivered
+                    continue;
+                }
+                if (!found->second.closing && (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP | EPOLLIN))) {
+                    receive(id);
+                }
+                found = connections.find(id);
+                if (found != connections.end() && (events[i].events & EPOLLOUT)) {
+                    flush(id, found->second);
+                    found = connections.find(id);
+                    if (found != connections.end()) {
+                        dispatch(id, found->second); // Closes it if that was the last reply
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(queueLock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    if (reloader.joinable()) {
+        reloader.join();
+    }
+    cout << "Server stopped after answering " << answered << " requests." << endl;
+}
+
+/**
+ * Worker thread: answer queued requests until the server stops
+ */
+void QueryServer::workerLoop() {
+    CatalogReader reader(catalog);
+    string response;
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> guard(queueLock);
+            jobReady.wait(guard, [&] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = move(jobs.front());
+            jobs.pop_front();
+        }
+        {
+            CatalogReadGuard tree(reader);       // Reloads swap trees between requests, never during one
+            answerQuery(*tree, job.request, job.response);
+        }
+        {
+            lock_guard<mutex> guard(queueLock);
+            done.push_back(move(job));
+        }
+        uint64_t one = 1;
+        if (write(wakeup, &one, sizeof(one)) < 0) {
+            // The counter can only fail by overflowing, and then the loop is awake anyway
+        }
+    }
+}
+
+/**
+ * Reload thread: build the new catalog next to the live one, publish it, then wait out
+ * the readers of the old tree and free it - none of which blocks a worker
+ */
+void QueryServer::reload() {
+    BinarySearchTree* fresh = new BinarySearchTree();
+    if (!loadSnapshot(catalogFile + ".snap", catalogFile, fresh)) {
+        loadCourses(catalogFile, fresh);
+    }
+    if (fresh->Size() > 0) {
+        fresh->Freeze();
+        catalog.Publish(fresh);
+        catalog.Synchronize();
+        cout << "Reloaded " << fresh->Size() << " courses." << endl;
+    }
+    else {
+        delete fresh;
+        cout << "Reload failed. Previous catalog still served." << endl;
+    }
+    reloading.store(false);
+}
+
+/**
+ * Accept every pending connection
+ */
+void QueryServer::accept() {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;                              // EAGAIN: none left (other errors: try later)
+        }
+        uint64_t id = nextId++;
+        connections[id] = Connection{ fd, string(), string(), false, false, false };
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = id;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/**
+ * Read everything available on a connection, then dispatch a request if one is complete
+ */
+void QueryServer::receive(uint64_t id) {
+    Connection& connection = connections[id];
+    char buffer[16384];
+    while (true) {
+        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            connection.closing = true;           // Peer is done sending (or the socket failed)
+            watch(id, connection);               // Stop level-triggered EPOLLIN/EPOLLRDHUP repeats
+        }
+        break;
+    }
+    if (connection.input.size() > MAX_REQUEST_BYTES && connection.input.find('\n') == string::npos) {
+        drop(id);                                // A line that never ends
+        return;
+    }
+    dispatch(id, connection);
+}
+
+/**
+ * Hand the next complete line to the workers unless one is already out; close the
+ * connection once the peer has gone and nothing is left to answer or write
+ */
+void QueryServer::dispatch(uint64_t id, Connection& connection) {
+    if (!connection.busy) {
+        size_t lineEnd = connection.input.find('\n');
+        if (lineEnd != string::npos) {
+            Job job;
+            job.connection = id;
+            job.request.assign(connection.input, 0, lineEnd);
+            connection.input.erase(0, lineEnd + 1);
+            connection.busy = true;
+            {
+                lock_guard<mutex> guard(queueLock);
+                jobs.push_back(move(job));
+            }
+            jobReady.notify_one();
+            return;
+        }
+    }
+    if (connection.closing && !connection.busy && connection.output.empty()) {
+        drop(id);
+    }
+}
+
+/**
+ * Write as much pending output as the socket takes; wait for EPOLLOUT for the rest
+ */
+void QueryServer::flush(uint64_t id, Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t written = send(connection.fd, connection.output.data() + sent,
+            connection.output.size() - sent, MSG_NOSIGNAL);
+        if (written > 0) {
+            sent += static_cast<size_t>(written);
+        }
+        else if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        else {
+            drop(id);                            // Peer is gone
+            return;
+        }
+    }
+    connection.output.erase(0, sent);
+
+    bool wantWrite = !connection.output.empty();
+    if (wantWrite != connection.writing) {
+        connection.writing = wantWrite;
+        watch(id, connection);
+    }
+}
+
+/**
+ * Update the events a connection waits for: input until the peer closes, output while
+ * a reply is pending
+ */
+void QueryServer::watch(uint64_t id, const Connection& connection) {
+    epoll_event event = {};
+    event.events = (connection.closing ? 0u : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP))
+        | (connection.writing ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.u64 = id;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+/**
+ * Take finished replies from the workers and send them
+ */
+void QueryServer::collect() {
+    uint64_t count;
+    if (read(wakeup, &count, sizeof(count)) < 0) {
+        // EAGAIN: another wakeup already drained the counter
+    }
+    vector<Job> finished;
+    {
+        lock_guard<mutex> guard(queueLock);
+        finished.swap(done);
+    }
+    for (Job& job : finished) {
+        answered++;
+        auto found = connections.find(job.connection);
+        if (found == connections.end()) {
+            continue;                            // The client disconnected meanwhile
+        }
+        Connection& connection = found->second;
+        connection.busy = false;
+        connection.output.append(job.response);
+        flush(job.connection, connection);
+        found = connections.find(job.connection);
+        if (found != connections.end()) {
+            dispatch(job.connection, found->second); // Pipelined lines may be waiting
+        }
+    }
+}
+
+/**
+ * Close a connection and forget it
+ */
+void QueryServer::drop(uint64_t id) {
+    auto found = connections.find(id);
+    if (found != connections.end()) {
+        close(found->second.fd);                 // Also removes it from the epoll set
+        connections.erase(found);
+    }
+}
+
+/**
+ * Load a catalog (from its snapshot when that is current) and serve it until stopped
+ * Send SIGHUP after editing the file to reload it without dropping connections
+ */
+void serveCatalog(const string& socketPath, const string& filename) {
+    BinarySearchTree* initial = new BinarySearchTree();
+    if (!loadSnapshot(filename + ".snap", filename, initial)) {
+        loadCourses(filename, initial);
+    }
+    if (initial->Size() == 0) {
+        delete initial;
+        cout << "Load failed - nothing to serve." << endl;
+        return;
+    }
+    initial->Freeze();
+    CatalogHandle catalog;
+    catalog.Publish(initial);
+
+    QueryServer server(catalog, filename);
+    if (!server.listen(socketPath)) {
+        return;
+    }
+    unsigned workerCount = max(1u, thread::hardware_concurrency());
+    if (workerCount > CatalogHandle::MAX_READERS) {
+        // Each worker holds a CatalogReader for its lifetime, so there can be no more than slots
+        cout << "Warning: " << workerCount << " hardware threads but only " << CatalogHandle::MAX_READERS
+            << " catalog reader slots - starting " << CatalogHandle::MAX_READERS << " workers" << endl;
+        workerCount = unsigned(CatalogHandle::MAX_READERS);
+    }
+    cout << "Serving " << initial->Size() << " courses on " << socketPath
+        << " with " << workerCount << " workers (Ctrl+C to stop)" << endl;
+    server.run(workerCount);
+    unlink(socketPath.c_str());
+}
+
+/**
+ * Blocking client connection for the load generator
+ */
+class QueryClient {
+private:
+    int fd;
+    string buffer;               // Received bytes not yet consumed
+    size_t consumed;
+
+    bool readLine(string_view& line);
+
+public:
+    QueryClient() : fd(-1), consumed(0) {}
+    ~QueryClient() { if (fd >= 0) close(fd); }
+
+    bool connect(const string& socketPath);
+    bool query(const string& request, vector<string>& lines); // Send one line, read one framed reply
+};
+
+bool QueryClient::connect(const string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    return fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+}
+
+bool QueryClient::readLine(string_view& line) {
+    while (true) {
+        size_t lineEnd = buffer.find('\n', consumed);
+        if (lineEnd != string::npos) {
+            line = string_view(buffer).substr(consumed, lineEnd - consumed);
+            consumed = lineEnd + 1;
+            return true;
+        }
+        buffer.erase(0, consumed);
+        consumed = 0;
+        char chunk[16384];
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+}
+
+bool QueryClient::query(const string& request, vector<string>& lines) {
+    lines.clear();
+    string message = request + "\n";
+    for (size_t sent = 0; sent < message.size();) {
+        ssize_t written = send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    string_view header;
+    if (!readLine(header) || header.substr(0, 3) != "OK ") {
+        return false;
+    }
+    size_t count = stoul(string(header.substr(3)));
+    for (size_t i = 0; i < count; i++) {
+        string_view line;
+        if (!readLine(line)) {
+            return false;
+        }
+        lines.emplace_back(line);
+    }
+    return true;
+}
+
+/**
+ * Closed-loop load generator: each connection runs on its own thread and sends its next
+ * query as soon as the previous reply arrives. The mix is mostly FIND, with BATCH (16
+ * keys), SEARCH and PREREQS. Reports queries/sec and latency percentiles.
+ */
+void runLoadTest(const string& socketPath, int connectionCount, double seconds) {
+    // Learn the catalog first so the queries hit real courses
+    QueryClient probe;
+    vector<string> lines;
+    if (!probe.connect(socketPath) || !probe.query("LIST", lines) || lines.empty()) {
+        cout << "Error: No catalog served on " << socketPath << endl;
+        return;
+    }
+    vector<string> numbers;
+    vector<string> nameWords;
+    for (const string& line : lines) {
+        size_t numberEnd = line.find('\t');
+        numbers.push_back(line.substr(0, numberEnd));
+        size_t nameEnd = line.find('\t', numberEnd + 1);
+        string name = line.substr(numberEnd + 1, nameEnd - numberEnd - 1);
+        size_t wordEnd = name.find(' ');
+        nameWords.push_back(name.substr(0, wordEnd));   // First word of the name
+    }
+
+    vector<vector<double>> latencies(connectionCount);  // Microseconds, per thread
+    vector<thread> threads;
+    auto deadline = chrono::steady_clock::now() + chrono::duration<double>(seconds);
+    for (int t = 0; t < connectionCount; t++) {
+        threads.emplace_back([&, t]() {
+            QueryClient client;
+            if (!client.connect(socketPath)) {
+                return;
+            }
+            vector<string> reply;
+            unsigned seed = 12345u + static_cast<unsigned>(t) * 7919u;
+            auto pick = [&](size_t range) {
+                seed = seed * 1103515245 + 12345;
+                return static_cast<size_t>(seed >> 8) % range;
+            };
+            string request;
+            while (chrono::steady_clock::now() < deadline) {
+                size_t kind = pick(100);
+                if (kind < 70) {
+                    request = "FIND " + numbers[pick(numbers.size())];
+                }
+                else if (kind < 80) {
+                    request = "BATCH";
+                    for (int i = 0; i < 16; i++) {
+                        request += " " + numbers[pick(numbers.size())];
+                    }
+                }
+                else if (kind < 90) {
+                    request = "SEARCH " + nameWords[pick(nameWords.size())];
+                }
+                else {
+                    request = "PREREQS " + numbers[pick(numbers.size())];
+                }
+                auto start = chrono::steady_clock::now();
+                if (!client.query(request, reply)) {
+                    return;
+                }
+                chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+                latencies[t].push_back(elapsed.count());
+            }
+        });
+    }
+    for (thread& worker : threads) {
+        worker.join();
+    }
+
+    vector<double> all;
+    for (const vector<double>& perThread : latencies) {
+        all.insert(all.end(), perThread.begin(), perThread.end());
+    }
+    if (all.empty()) {
+        cout << "Error: No queries completed." << endl;
+        return;
+    }
+    sort(all.begin(), all.end());
+    auto percentile = [&](double fraction) {
+        return static_cast<long long>(all[min(all.size() - 1, static_cast<size_t>(fraction * all.size()))]);
+    };
+    cout << "Load test: " << connectionCount << " connections, " << seconds << " s, "
+        << numbers.size() << " courses" << endl;
+    cout << "  " << all.size() << " queries, " << static_cast<long long>(all.size() / seconds) << " queries/sec" << endl;
+    cout << "  latency p50 " << percentile(0.50) << " us, p99 " << percentile(0.99)
+        << " us, max " << static_cast<long long>(all.back()) << " us" << endl;
+}
+#endif
+
+//===============//
+// Main Function //
+//===============//
+
+int main(int argc, char* argv[]) {
+#ifdef __linux__
+    if (argc == 4 && string(argv[1]) == "--serve") {
+        serveCatalog(argv[2], argv[3]); // Query daemon on a Unix domain socket
+        return 0;
+    }
+    if (argc >= 3 && argc <= 5 && string(argv[1]) == "--load-test") {
+        int connections = argc >= 4 ? max(1, atoi(argv[3])) : 8;
+        double seconds = argc >= 5 ? max(0.1, atof(argv[4])) : 5.0;
+        runLoadTest(argv[2], connections, seconds); // Queries/sec and p99 against a running daemon
+        return 0;
+    }
+    cout << "Usage: " << argv[0] << " --serve SOCKET FILE" << endl;
+    cout << "       " << argv[0] << " --load-test SOCKET [CONNECTIONS] [SECONDS]" << endl;
+#else
+    (void)argc;
+    (void)argv;
+    cout << "The catalog daemon is only supported on Linux." << endl;
+#endif
+    return 1;
+}
\ No newline at end of file
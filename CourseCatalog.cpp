@@ -0,0 +1,3971 @@
+//=========================================================================//
+// Name        : CourseCatalog.cpp                                         //
+// Author      : GCZ79                                                     //
+// Version     : 1.0                                                       //
+// Date        : 02/21/2026                                                //
+// Description : Catalog loading, indexing, snapshots and queries          //
+//=========================================================================//
+
+#include "CourseCatalog.h"
+
+#include <bitset>    // bitset::count() - portable population count of closure rows
+#include <cctype>    // toupper() - per-character case folding for string_view keys
+#include <chrono>    // steady_clock - load phase and search timings
+#include <filesystem> // file_size()/last_write_time() - snapshot freshness check
+#include <fstream>   // ofstream - writes catalog snapshots
+#include <sstream>   // stringstream - parses CSV lines in split() function
+#include <thread>    // thread - parallel prerequisite validation on large catalogs
+#include <unordered_set> // unordered_set - hashed course number index for validation
+
+#ifndef _WIN32
+#include <fcntl.h>    // open() - file descriptor for mmap
+#include <sys/mman.h> // mmap()/munmap() - memory-mapped CSV loading
+#include <sys/stat.h> // fstat() - file size for mmap
+#include <unistd.h>   // close()
+#endif
+
+#ifdef ABCU_ENABLE_STATS
+#include <cstdlib>   // malloc()/free()/posix_memalign() - counting operator new
+#include <new>       // bad_alloc/align_val_t - counting operator new
+#ifdef _WIN32
+#include <malloc.h>  // _aligned_malloc()/_aligned_free() - counting aligned operator new
+#endif
+#endif
+
+//======================================//
+// Arena Allocator and String Interning //
+//======================================//
+
+/**
+ * Carve bytes out of the current block, starting a new block when it runs out
+ * Requests larger than a block get a block of their own
+ */
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+    if (cursor == nullptr || padding + bytes > remaining) {
+        size_t size = max(blockSize, bytes + alignment);
+        char* block = new char[size];
+        blocks.push_back(block);
+        reserved += size;
+        cursor = block;
+        remaining = size;
+        padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+    }
+    char* result = cursor + padding;
+    cursor = result + bytes;
+    remaining -= padding + bytes;
+    return result;
+}
+
+/**
+ * Free all memory handed out by this arena
+ */
+void Arena::release() {
+    for (char* block : blocks) {
+        delete[] block;
+    }
+    blocks.clear();
+    cursor = nullptr;
+    remaining = 0;
+    reserved = 0;
+}
+
+void Arena::swap(Arena& other) {
+    blocks.swap(other.blocks);
+    std::swap(cursor, other.cursor);
+    std::swap(remaining, other.remaining);
+    std::swap(blockSize, other.blockSize);
+    std::swap(reserved, other.reserved);
+}
+
+uint32_t StringPool::intern(string_view str) {
+    auto found = ids.find(str);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    string_view stored = store(str);        // The map key must point at the pooled copy
+    strings.push_back(stored);
+    ids.emplace(stored, id);
+    return id;
+}
+
+string_view StringPool::store(string_view str) {
+    if (str.empty()) {
+        return string_view();
+    }
+    char* bytes = static_cast<char*>(arena.allocate(str.size(), 1));
+    memcpy(bytes, str.data(), str.size());
+    return string_view(bytes, str.size());
+}
+
+uint32_t* StringPool::allocateIds(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    return static_cast<uint32_t*>(arena.allocate(count * sizeof(uint32_t), alignof(uint32_t)));
+}
+
+void StringPool::clear() {
+    ids.clear();
+    strings.clear();
+    arena.release();
+}
+
+void StringPool::swap(StringPool& other) {
+    arena.swap(other.arena);
+    ids.swap(other.ids);
+    strings.swap(other.strings);
+}
+
+/**
+ * Intern a Course into a pool
+ */
+StoredCourse storeCourse(const Course& course, StringPool& pool) {
+    StoredCourse stored;
+    stored.courseNumber = pool.view(pool.intern(course.courseNumber));
+    stored.courseName = pool.store(course.courseName);
+    stored.prerequisiteCount = static_cast<uint32_t>(course.prerequisites.size());
+    uint32_t* ids = pool.allocateIds(course.prerequisites.size());
+    for (size_t i = 0; i < course.prerequisites.size(); i++) {
+        ids[i] = pool.intern(course.prerequisites[i]);
+    }
+    stored.prerequisites = ids;
+    return stored;
+}
+
+/**
+ * Intern a course given as borrowed views (no temporary Course or strings needed)
+ */
+StoredCourse storeCourseViews(string_view courseNumber, string_view courseName,
+    const string_view* prerequisites, size_t prerequisiteCount, StringPool& pool) {
+    StoredCourse stored;
+    stored.courseNumber = pool.view(pool.intern(courseNumber));
+    stored.courseName = pool.store(courseName);
+    stored.prerequisiteCount = static_cast<uint32_t>(prerequisiteCount);
+    uint32_t* ids = pool.allocateIds(prerequisiteCount);
+    for (size_t i = 0; i < prerequisiteCount; i++) {
+        ids[i] = pool.intern(prerequisites[i]);
+    }
+    stored.prerequisites = ids;
+    return stored;
+}
+
+/**
+ * Build an owning Course from a stored record
+ */
+Course toCourse(const StoredCourse& stored, const StringPool& pool) {
+    Course course;
+    course.courseNumber.assign(stored.courseNumber);
+    course.courseName.assign(stored.courseName);
+    course.prerequisites.reserve(stored.prerequisiteCount);
+    for (uint32_t i = 0; i < stored.prerequisiteCount; i++) {
+        course.prerequisites.emplace_back(pool.view(stored.prerequisites[i]));
+    }
+    return course;
+}
+
+//====================//
+// Memory-Mapped File //
+//====================//
+
+/**
+ * Open and map the file (check isOpen() afterwards)
+ */
+MappedFile::MappedFile(const string& filename) {
+    contents = nullptr;
+    length = 0;
+    opened = false;
+#ifdef _WIN32
+    mappingHandle = nullptr;
+    fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        return;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length > 0) {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            return;
+        }
+        contents = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (contents == nullptr) {
+            return;
+        }
+    }
+    opened = true;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            length = 0;
+            return;
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL); // Parsed front to back - read ahead aggressively
+        contents = static_cast<const char*>(mapping);
+    }
+    close(fd);            // The mapping stays valid after the descriptor is closed
+    opened = true;
+#endif
+}
+
+/**
+ * Unmap the file
+ */
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (contents != nullptr) UnmapViewOfFile(contents);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+#else
+    if (contents != nullptr) {
+        munmap(const_cast<char*>(contents), length);
+    }
+#endif
+}
+
+//==================//
+// Catalog Snapshot //
+//==================//
+
+/**
+ * Size and last-write time of a file (false if it does not exist)
+ */
+static bool sourceStamp(const string& filename, uint64_t& size, int64_t& modified) {
+    error_code error;
+    size = filesystem::file_size(filename, error);
+    if (error) {
+        return false;
+    }
+    auto writeTime = filesystem::last_write_time(filename, error);
+    if (error) {
+        return false;
+    }
+    modified = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * Map a snapshot and check that it is complete, self-consistent and sorted
+ */
+CatalogSnapshot::CatalogSnapshot(const string& filename) : file(filename) {
+    header = nullptr;
+    courses = nullptr;
+    prerequisiteList = nullptr;
+    pool = nullptr;
+    valid = false;
+
+    if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) {
+        return;
+    }
+    header = reinterpret_cast<const SnapshotHeader*>(file.data());
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || header->version != SNAPSHOT_VERSION || header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        return;                 // Foreign, outdated or other-endian file - rebuild from CSV
+    }
+
+    // Sections must exactly fill the file
+    uint64_t expected = sizeof(SnapshotHeader) + header->courseCount * sizeof(SnapshotCourse)
+        + header->prerequisiteCount * sizeof(SnapshotString) + header->poolSize;
+    if (header->courseCount > file.size() || header->prerequisiteCount > file.size()
+        || header->poolSize > file.size() || expected != file.size()) {
+        return;
+    }
+    courses = reinterpret_cast<const SnapshotCourse*>(file.data() + sizeof(SnapshotHeader));
+    prerequisiteList = reinterpret_cast<const SnapshotString*>(courses + header->courseCount);
+    pool = reinterpret_cast<const char*>(prerequisiteList + header->prerequisiteCount);
+
+    // Bounds-check every reference once so lookups never have to, and make sure the
+    // binary searches are searching strictly ascending course numbers
+    for (uint64_t i = 0; i < header->courseCount; i++) {
+        const SnapshotCourse& course = courses[i];
+        if (!inPool(course.number) || !inPool(course.name)
+            || uint64_t(course.firstPrerequisite) + course.prerequisiteCount > header->prerequisiteCount
+            || comparePacked(course.key, packKey(text(course.number))) != 0) {
+            return;
+        }
+        if (i > 0 && compareKeys(courses[i - 1].key, text(courses[i - 1].number),
+            course.key, text(course.number)) >= 0) {
+            return;
+        }
+    }
+    for (uint64_t i = 0; i < header->prerequisiteCount; i++) {
+        if (!inPool(prerequisiteList[i])) {
+            return;
+        }
+    }
+    valid = true;
+}
+
+/**
+ * Whether the snapshot was built from the current version of sourceFile
+ * (same size and last-write time), from an older one, or sourceFile is gone
+ */
+SnapshotSource CatalogSnapshot::checkSource(const string& sourceFile) const {
+    uint64_t size;
+    int64_t modified;
+    if (!valid) {
+        return SOURCE_CHANGED;  // Nothing trustworthy to compare against
+    }
+    if (!sourceStamp(sourceFile, size, modified)) {
+        return SOURCE_MISSING;
+    }
+    if (size != header->sourceSize || modified != header->sourceModified) {
+        return SOURCE_CHANGED;
+    }
+    return SOURCE_CURRENT;
+}
+
+/**
+ * Binary search over the sorted course array (key must already be uppercase)
+ */
+long CatalogSnapshot::find(string_view courseNumber) const {
+    size_t index = lowerBound(courseNumber);
+    if (index == size() || number(index) != courseNumber) {
+        return -1;
+    }
+    return static_cast<long>(index);
+}
+
+/**
+ * Index of the first course number not less than the key (size() if there is none)
+ */
+size_t CatalogSnapshot::lowerBound(string_view courseNumber) const {
+    PackedKey probe = packKey(courseNumber);
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (compareKeys(courses[middle].key, number(middle), probe, courseNumber) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Lower bound when the answer is known to be at or after first (e.g. for ascending keys)
+ * Gallops forward in doubling steps, then binary searches the last step - O(log d) for
+ * an answer d entries away instead of O(log n)
+ */
+size_t CatalogSnapshot::lowerBoundFrom(string_view courseNumber, size_t first) const {
+    PackedKey probe = packKey(courseNumber);
+    size_t low = first;
+    size_t step = 1;
+    while (low + step <= size()
+        && compareKeys(courses[low + step - 1].key, number(low + step - 1), probe, courseNumber) < 0) {
+        low += step;                      // Everything up to low is below the key
+        step *= 2;
+    }
+    size_t high = min(low + step, size());
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (compareKeys(courses[middle].key, number(middle), probe, courseNumber) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Build an owning Course for one entry
+ */
+Course CatalogSnapshot::materialize(size_t index) const {
+    Course course;
+    course.courseNumber.assign(number(index));
+    course.courseName.assign(name(index));
+    for (size_t i = 0; i < prerequisiteCount(index); i++) {
+        course.prerequisites.emplace_back(prerequisite(index, i));
+    }
+    return course;
+}
+
+/**
+ * Copy one entry into a string pool (used when a snapshot-backed tree turns back into nodes)
+ */
+StoredCourse CatalogSnapshot::store(size_t index, StringPool& pool) const {
+    StoredCourse stored;
+    stored.courseNumber = pool.view(pool.intern(number(index)));
+    stored.courseName = pool.store(name(index));
+    stored.prerequisiteCount = static_cast<uint32_t>(prerequisiteCount(index));
+    uint32_t* ids = pool.allocateIds(stored.prerequisiteCount);
+    for (uint32_t i = 0; i < stored.prerequisiteCount; i++) {
+        ids[i] = pool.intern(prerequisite(index, i));
+    }
+    stored.prerequisites = ids;
+    return stored;
+}
+
+/**
+ * Write courses (already sorted by course number) to a snapshot file
+ * The file is written under a temporary name and then renamed over the target, so a
+ * crash mid-write never leaves a truncated snapshot behind; a failed write or rename
+ * deletes the temporary file
+ */
+bool CatalogSnapshot::Write(const string& filename, const vector<const StoredCourse*>& sortedCourses,
+    const StringPool& pool, const string& sourceFile) {
+    SnapshotHeader fileHeader = {};
+    memcpy(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    fileHeader.version = SNAPSHOT_VERSION;
+    fileHeader.byteOrder = SNAPSHOT_BYTE_ORDER;
+    if (!sourceStamp(sourceFile, fileHeader.sourceSize, fileHeader.sourceModified)) {
+        fileHeader.sourceSize = 0;
+        fileHeader.sourceModified = 0;
+    }
+
+    // Flatten everything into the three sections
+    vector<SnapshotCourse> entries;
+    vector<SnapshotString> prerequisites;
+    string stringPool;
+    auto addString = [&](string_view str) {
+        SnapshotString ref = { static_cast<uint32_t>(stringPool.size()), static_cast<uint32_t>(str.size()) };
+        stringPool.append(str.data(), str.size());
+        return ref;
+    };
+    entries.reserve(sortedCourses.size());
+    for (const StoredCourse* course : sortedCourses) {
+        SnapshotCourse entry;
+        entry.key = packKey(course->courseNumber);
+        entry.number = addString(course->courseNumber);
+        entry.name = addString(course->courseName);
+        entry.firstPrerequisite = static_cast<uint32_t>(prerequisites.size());
+        entry.prerequisiteCount = course->prerequisiteCount;
+        for (uint32_t i = 0; i < course->prerequisiteCount; i++) {
+            prerequisites.push_back(addString(pool.view(course->prerequisites[i])));
+        }
+        entries.push_back(entry);
+    }
+    if (stringPool.size() > UINT32_MAX || prerequisites.size() > UINT32_MAX) {
+        return false;           // Offsets are 32-bit
+    }
+    fileHeader.courseCount = entries.size();
+    fileHeader.prerequisiteCount = prerequisites.size();
+    fileHeader.poolSize = stringPool.size();
+
+    string temporary = filename + ".tmp";
+    ofstream out(temporary, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotCourse));
+    out.write(reinterpret_cast<const char*>(prerequisites.data()),
+        prerequisites.size() * sizeof(SnapshotString));
+    out.write(stringPool.data(), stringPool.size());
+    out.close();                // Flushes - a full disk shows up here, not in write()
+
+    error_code error;
+    if (!out) {
+        filesystem::remove(temporary, error);
+        return false;
+    }
+    filesystem::rename(temporary, filename, error);
+    if (error) {
+        filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+//=====================//
+// Frozen Search Index //
+//=====================//
+
+/**
+ * Lay out the keys (sortedCourses must be sorted and free of duplicates)
+ */
+FrozenIndex::FrozenIndex(vector<StoredCourse>&& sortedCourses) : courses(move(sortedCourses)) {
+    count = courses.size();
+    longKeys = false;
+    for (const StoredCourse& course : courses) {
+        longKeys = longKeys || course.courseNumber.size() > PACKED_KEY_BYTES;
+    }
+
+    // Aligned so that the four keys sharing a cache line are always siblings/cousins
+    keys = static_cast<PackedKey*>(::operator new((count + 1) * sizeof(PackedKey), align_val_t(64)));
+    ranks = new uint32_t[count + 1];
+    keys[0] = PackedKey();
+    ranks[0] = 0;
+    fill(1, 0);
+}
+
+FrozenIndex::~FrozenIndex() {
+    ::operator delete(keys, align_val_t(64));
+    delete[] ranks;
+}
+
+/**
+ * In-order walk of the implicit tree (children of slot k are 2k and 2k+1), assigning
+ * sorted courses as it goes. Returns the next unassigned rank. Depth is log2(n).
+ */
+size_t FrozenIndex::fill(size_t slot, size_t next) {
+    if (slot > count) {
+        return next;
+    }
+    next = fill(2 * slot, next);
+    keys[slot] = packKey(courses[next].courseNumber);
+    ranks[slot] = static_cast<uint32_t>(next);
+    return fill(2 * slot + 1, next + 1);
+}
+
+/**
+ * Compare the key in a slot with the probe (<0, 0, >0)
+ * Only the packed words are read unless a long course number is involved
+ */
+int FrozenIndex::compareSlot(size_t slot, const PackedKey& probe, string_view key) const {
+    int order = comparePacked(keys[slot], probe);
+    if (order != 0 || (!longKeys && key.size() <= PACKED_KEY_BYTES)) {
+        return order;
+    }
+    return compareKeys(keys[slot], courses[ranks[slot]].courseNumber, probe, key); // Same 16-byte prefix - rare
+}
+
+/**
+ * Branch-free Eytzinger descent: go right while the slot key is smaller than the probe,
+ * then recover the lower bound from the bits of the final position (0 if every key is smaller)
+ */
+size_t FrozenIndex::lowerSlot(const PackedKey& probe, string_view key) const {
+    size_t slot = 1;
+    while (slot <= count) {
+        ABCU_PREFETCH(keys + 4 * slot);     // Grandchildren share one cache line
+        slot = 2 * slot + (compareSlot(slot, probe, key) < 0 ? 1 : 0);
+    }
+    return slot >> (lowestBit(~uint64_t(slot)) + 1); // Undo the trailing right turns
+}
+
+/**
+ * Exact lookup: the lower bound, if its key matches
+ */
+long FrozenIndex::find(string_view courseNumber) const {
+    PackedKey probe = packKey(courseNumber);
+    size_t slot = lowerSlot(probe, courseNumber);
+    if (slot == 0 || compareSlot(slot, probe, courseNumber) != 0) {
+        return -1;
+    }
+    return static_cast<long>(ranks[slot]);
+}
+
+/**
+ * Rank of the first course number not less than the key (size() if there is none)
+ */
+size_t FrozenIndex::lowerBound(string_view courseNumber) const {
+    size_t slot = lowerSlot(packKey(courseNumber), courseNumber);
+    return slot == 0 ? count : ranks[slot];
+}
+
+/**
+ * find() for many keys, eight descents interleaved level by level
+ * A single descent stalls on each level's cache miss; stepping eight independent
+ * descents in lockstep (and prefetching each one's next line) keeps eight misses in
+ * flight at once. Keys must be uppercase; ranks[i] receives find(courseNumbers[i]).
+ */
+void FrozenIndex::findBatch(const string_view* courseNumbers, size_t total, long* results) const {
+    const size_t LANES = 8;
+    PackedKey probes[LANES];
+    size_t slots[LANES];
+    for (size_t base = 0; base < total; base += LANES) {
+        size_t lanes = min(LANES, total - base);
+        for (size_t lane = 0; lane < lanes; lane++) {
+            probes[lane] = packKey(courseNumbers[base + lane]);
+            slots[lane] = 1;
+        }
+        bool descending = true;
+        while (descending) {
+            descending = false;
+            for (size_t lane = 0; lane < lanes; lane++) {
+                size_t slot = slots[lane];
+                if (slot <= count) {
+                    slot = 2 * slot + (compareSlot(slot, probes[lane], courseNumbers[base + lane]) < 0 ? 1 : 0);
+                    ABCU_PREFETCH(keys + min(4 * slot, count)); // Next level for this lane
+                    slots[lane] = slot;
+                    descending = true;
+                }
+            }
+        }
+        for (size_t lane = 0; lane < lanes; lane++) {
+            size_t slot = slots[lane] >> (lowestBit(~uint64_t(slots[lane])) + 1);
+            bool found = slot != 0 && compareSlot(slot, probes[lane], courseNumbers[base + lane]) == 0;
+            results[base + lane] = found ? static_cast<long>(ranks[slot]) : -1;
+        }
+    }
+}
+
+/**
+ * Levels in the implicit tree: floor(log2(n)) + 1
+ */
+int FrozenIndex::depth() const {
+    int levels = 0;
+    for (size_t remaining = count; remaining > 0; remaining /= 2) {
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ * Give the sorted courses back so the tree can be rebuilt from them
+ */
+vector<StoredCourse> FrozenIndex::release() {
+    count = 0;
+    return move(courses);
+}
+
+//====================//
+// Prerequisite Graph //
+//====================//
+
+/**
+ * OR one bitset row into another: dst |= src over a whole number of 256-bit blocks
+ * Rows are 32-byte aligned and padded to a multiple of four words, so there are no tails.
+ */
+static void orRowScalar(uint64_t* dst, const uint64_t* src, size_t words) {
+    for (size_t i = 0; i < words; i++) {
+        dst[i] |= src[i];
+    }
+}
+
+#ifdef ABCU_X86_64
+static bool cpuHasAvx2();
+
+static void orRowSse2(uint64_t* dst, const uint64_t* src, size_t words) {
+    for (size_t i = 0; i < words; i += 2) {
+        __m128i merged = _mm_or_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(dst + i)),
+            _mm_load_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), merged);
+    }
+}
+
+ABCU_TARGET_AVX2 static void orRowAvx2(uint64_t* dst, const uint64_t* src, size_t words) {
+    for (size_t i = 0; i < words; i += 4) {
+        __m256i merged = _mm256_or_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i)),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), merged);
+    }
+}
+#endif
+
+/**
+ * Build the graph from a sorted run of courses (e.g. tree.begin() to tree.end())
+ * Prerequisites that are not in the catalog, repeats and self-references are ignored.
+ */
+PrerequisiteGraph::PrerequisiteGraph(CourseIterator first, CourseIterator last) {
+    closure = nullptr;
+    rowWords = 0;
+
+    // Pass 1: dense IDs are positions in the sorted run
+    for (CourseIterator it = first; it != last; ++it) {
+        numbers.push_back((*it).number());
+        keys.push_back(packKey(numbers.back()));
+    }
+    size_t count = numbers.size();
+
+    // Pass 2: prerequisite lists, resolved to IDs by binary search over the sorted numbers
+    prerequisiteOffsets.reserve(count + 1);
+    prerequisiteOffsets.push_back(0);
+    vector<uint32_t> dependentCounts(count, 0);
+    uint32_t id = 0;
+    for (CourseIterator it = first; it != last; ++it, id++) {
+        CourseRef course = *it;
+        size_t listStart = prerequisiteIds.size();
+        for (size_t i = 0; i < course.prerequisiteCount(); i++) {
+            long target = find(course.prerequisite(i));
+            if (static_cast<uint32_t>(target) == id &&
+                (selfReferences.empty() || selfReferences.back() != id)) {
+                selfReferences.push_back(id);   // Kept out of the edges, but still a cycle
+            }
+            if (target < 0 || static_cast<uint32_t>(target) == id ||
+                std::find(prerequisiteIds.begin() + listStart, prerequisiteIds.end(), target) != prerequisiteIds.end()) {
+                continue;
+            }
+            prerequisiteIds.push_back(static_cast<uint32_t>(target));
+            dependentCounts[target]++;
+        }
+        prerequisiteOffsets.push_back(static_cast<uint32_t>(prerequisiteIds.size()));
+    }
+
+    // Reverse edges by counting sort into CSR
+    dependentOffsets.assign(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        dependentOffsets[i + 1] = dependentOffsets[i] + dependentCounts[i];
+    }
+    dependentIds.resize(prerequisiteIds.size());
+    vector<uint32_t> cursor(dependentOffsets.begin(), dependentOffsets.end() - 1);
+    for (uint32_t course = 0; course < count; course++) {
+        for (size_t i = 0; i < prerequisiteCount(course); i++) {
+            dependentIds[cursor[prerequisites(course)[i]]++] = course;
+        }
+    }
+
+    // Kahn's algorithm: a course is ready once every one of its prerequisites is placed
+    vector<uint32_t> pending(count);
+    for (uint32_t course = 0; course < count; course++) {
+        pending[course] = static_cast<uint32_t>(prerequisiteCount(course));
+        if (pending[course] == 0) {
+            order.push_back(course);
+        }
+    }
+    for (size_t next = 0; next < order.size(); next++) {
+        uint32_t placed = order[next];
+        for (size_t i = 0; i < dependentCount(placed); i++) {
+            uint32_t dependent = dependents(placed)[i];
+            if (--pending[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+
+    findCycles();
+    if (count > 0 && count <= CLOSURE_MAX_COURSES) {
+        buildClosure();
+    }
+}
+
+PrerequisiteGraph::~PrerequisiteGraph() {
+    if (closure != nullptr) {
+        ::operator delete(closure, align_val_t(32));
+    }
+}
+
+/**
+ * Fill the closure rows. In topological order every prerequisite's row is final before
+ * it is read, so one OR per edge suffices. Courses on a cycle never enter the order;
+ * their rows are iterated to a fixed point instead (rare, and bounded by the cycle length).
+ */
+void PrerequisiteGraph::buildClosure() {
+    size_t count = numbers.size();
+    rowWords = ((count + 63) / 64 + 3) & ~size_t(3);
+    size_t bytes = count * rowWords * sizeof(uint64_t);
+    closure = static_cast<uint64_t*>(::operator new(bytes, align_val_t(32)));
+    memset(closure, 0, bytes);
+
+    void (*orRow)(uint64_t*, const uint64_t*, size_t) = orRowScalar;
+#ifdef ABCU_X86_64
+    orRow = cpuHasAvx2() ? orRowAvx2 : orRowSse2;
+#endif
+
+    auto propagate = [&](uint32_t course) {
+        uint64_t* target = closure + course * rowWords;
+        for (size_t i = 0; i < prerequisiteCount(course); i++) {
+            uint32_t prerequisite = prerequisites(course)[i];
+            orRow(target, row(prerequisite), rowWords);
+            target[prerequisite / 64] |= uint64_t(1) << (prerequisite % 64);
+        }
+    };
+    for (uint32_t course : order) {
+        propagate(course);
+    }
+
+    if (order.size() < count) {
+        vector<bool> ordered(count, false);
+        for (uint32_t course : order) {
+            ordered[course] = true;
+        }
+        vector<uint64_t> before(rowWords);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (uint32_t course = 0; course < count; course++) {
+                if (ordered[course]) {
+                    continue;
+                }
+                uint64_t* target = closure + course * rowWords;
+                memcpy(before.data(), target, rowWords * sizeof(uint64_t));
+                propagate(course);
+                changed = changed || memcmp(before.data(), target, rowWords * sizeof(uint64_t)) != 0;
+            }
+        }
+    }
+}
+
+/**
+ * Find the prerequisite cycles in linear time. Only courses Kahn's algorithm could not
+ * place can be on a cycle, so Tarjan's algorithm (iterative, so long chains cannot
+ * overflow the call stack) runs over just those. Each strongly connected component with
+ * more than one course holds at least one cycle; a concrete one is recovered by walking
+ * prerequisite edges inside the component until a course repeats.
+ */
+void PrerequisiteGraph::findCycles() {
+    for (uint32_t course : selfReferences) {
+        cycles.push_back({ course, course });
+    }
+    size_t count = numbers.size();
+    if (order.size() == count) {
+        return;                             // Every course was placed - no cycles
+    }
+
+    const uint32_t UNVISITED = UINT32_MAX;
+    vector<uint32_t> visitIndex(count, UNVISITED);
+    vector<uint32_t> lowLink(count, 0);
+    vector<char> onStack(count, 0);
+    vector<uint32_t> component(count, UNVISITED);
+    vector<uint32_t> walkPosition(count, UNVISITED); // Position of a course in the current cycle walk
+    for (uint32_t placed : order) {
+        visitIndex[placed] = 0;             // Acyclic courses are never entered
+        component[placed] = placed;
+    }
+    vector<uint32_t> sccStack;
+    vector<pair<uint32_t, size_t>> callStack; // (course, next edge to explore)
+    uint32_t nextIndex = 1;
+
+    for (uint32_t start = 0; start < count; start++) {
+        if (visitIndex[start] != UNVISITED) {
+            continue;
+        }
+        callStack.push_back({ start, 0 });
+        visitIndex[start] = lowLink[start] = nextIndex++;
+        sccStack.push_back(start);
+        onStack[start] = 1;
+
+        while (!callStack.empty()) {
+            uint32_t course = callStack.back().first;
+            size_t& edge = callStack.back().second;
+            if (edge < prerequisiteCount(course)) {
+                uint32_t next = prerequisites(course)[edge++];
+                if (visitIndex[next] == UNVISITED) {
+                    visitIndex[next] = lowLink[next] = nextIndex++;
+                    sccStack.push_back(next);
+                    onStack[next] = 1;
+                    callStack.push_back({ next, 0 });
+                }
+                else if (onStack[next]) {
+                    lowLink[course] = min(lowLink[course], visitIndex[next]);
+                }
+                continue;
+            }
+
+            // All edges explored - close the component if course is its root
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                uint32_t caller = callStack.back().first;
+                lowLink[caller] = min(lowLink[caller], lowLink[course]);
+            }
+            if (lowLink[course] != visitIndex[course]) {
+                continue;
+            }
+            size_t first = sccStack.size();
+            do {
+                first--;
+                onStack[sccStack[first]] = 0;
+                component[sccStack[first]] = course;
+            } while (sccStack[first] != course);
+            bool multiple = sccStack.size() - first > 1;
+            sccStack.resize(first);
+            if (!multiple) {
+                continue;
+            }
+
+            // Walk inside the component until a course repeats; the loop from there is a cycle
+            vector<uint32_t> walk;
+            uint32_t current = course;
+            while (walkPosition[current] == UNVISITED) {
+                walkPosition[current] = static_cast<uint32_t>(walk.size());
+                walk.push_back(current);
+                for (size_t i = 0; i < prerequisiteCount(current); i++) {
+                    uint32_t next = prerequisites(current)[i];
+                    if (component[next] == course) {
+                        current = next;
+                        break;
+                    }
+                }
+            }
+            vector<uint32_t> cycle(walk.begin() + walkPosition[current], walk.end());
+            cycle.push_back(current);
+            cycles.push_back(move(cycle));
+            for (uint32_t visited : walk) {
+                walkPosition[visited] = UNVISITED;
+            }
+        }
+    }
+}
+
+/**
+ * Binary search over the packed keys for a course number's ID
+ */
+long PrerequisiteGraph::find(string_view courseNumber) const {
+    PackedKey probe = packKey(courseNumber);
+    size_t low = 0;
+    size_t high = keys.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (compareKeys(keys[middle], numbers[middle], probe, courseNumber) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    if (low == keys.size() || compareKeys(keys[low], numbers[low], probe, courseNumber) != 0) {
+        return -1;
+    }
+    return static_cast<long>(low);
+}
+
+/**
+ * True if prerequisite must be taken (directly or through a chain) before course
+ * One bit test with a closure; otherwise a depth-first walk of the prerequisite edges
+ */
+bool PrerequisiteGraph::isRequired(uint32_t course, uint32_t prerequisite) const {
+    if (closure != nullptr) {
+        return (row(course)[prerequisite / 64] >> (prerequisite % 64)) & 1;
+    }
+    vector<bool> seen(numbers.size(), false);
+    vector<uint32_t> stack(1, course);
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        for (size_t i = 0; i < prerequisiteCount(current); i++) {
+            uint32_t next = prerequisites(current)[i];
+            if (next == prerequisite) {
+                return true;
+            }
+            if (!seen[next]) {
+                seen[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Every course required before course, directly or transitively, as IDs in alphanumeric
+ * order. Read straight off the closure row's set bits when there is one.
+ */
+vector<uint32_t> PrerequisiteGraph::allPrerequisites(uint32_t course) const {
+    vector<uint32_t> chain;
+    if (closure != nullptr) {
+        forEachPrerequisite(course, [&](uint32_t id) { chain.push_back(id); });
+        return chain;
+    }
+    vector<bool> seen(numbers.size(), false);
+    vector<uint32_t> stack(1, course);
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        for (size_t i = 0; i < prerequisiteCount(current); i++) {
+            uint32_t next = prerequisites(current)[i];
+            if (!seen[next]) {
+                seen[next] = true;
+                chain.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+    sort(chain.begin(), chain.end());
+    return chain;
+}
+
+/**
+ * Number of courses in the full chain - a population count of the closure row
+ */
+size_t PrerequisiteGraph::allPrerequisiteCount(uint32_t course) const {
+    if (closure == nullptr) {
+        return allPrerequisites(course).size();
+    }
+    size_t total = 0;
+    const uint64_t* bits = row(course);
+    for (size_t word = 0; word < rowWords; word++) {
+        total += bitset<64>(bits[word]).count();
+    }
+    return total;
+}
+
+SemesterPlanner::SemesterPlanner(const PrerequisiteGraph& prerequisiteGraph) : graph(prerequisiteGraph) {
+    reset();
+}
+
+/**
+ * Forget every completed course - O(V)
+ */
+void SemesterPlanner::reset() {
+    size_t count = graph.size();
+    missing.resize(count);
+    completed.assign(count, 0);
+    for (uint32_t course = 0; course < count; course++) {
+        missing[course] = static_cast<uint32_t>(graph.prerequisiteCount(course));
+    }
+    for (uint32_t course : graph.selfReferencingCourses()) {
+        missing[course]++;        // Waits on itself - never available
+    }
+}
+
+/**
+ * Mark a course completed; each course that lists it has one fewer prerequisite missing
+ * A course may be recorded as completed even if its own prerequisites are not
+ */
+void SemesterPlanner::complete(uint32_t course) {
+    if (completed[course]) {
+        return;
+    }
+    completed[course] = 1;
+    for (size_t i = 0; i < graph.dependentCount(course); i++) {
+        missing[graph.dependents(course)[i]]--;
+    }
+}
+
+/**
+ * Courses not yet completed whose prerequisites all are, in alphanumeric order
+ */
+void SemesterPlanner::available(vector<uint32_t>& courses) const {
+    courses.clear();
+    for (uint32_t course = 0; course < graph.size(); course++) {
+        if (isAvailable(course)) {
+            courses.push_back(course);
+        }
+    }
+}
+
+/**
+ * Layered topological order: semester 1 is what is available now, and every later
+ * semester holds the courses whose prerequisites are all completed or planned earlier.
+ * Ready courses wait in one FIFO, so with a course limit the overflow simply stays at the
+ * front for the next semester and each course and edge is handled once - O(V+E).
+ * Courses within a semester come out in the order they became ready, not sorted.
+ * The student's own state is left unchanged.
+ */
+size_t SemesterPlanner::plan(vector<uint32_t>& courses, vector<uint32_t>& semesterStarts, size_t maxPerSemester) {
+    courses.clear();
+    semesterStarts.assign(1, 0);
+    remaining = missing;
+    available(ready);
+
+    size_t toSchedule = 0;
+    for (char done : completed) {
+        toSchedule += done ? 0 : 1;
+    }
+
+    size_t head = 0;                                  // Next course to plan in ready
+    while (head < ready.size()) {
+        size_t semesterEnd = ready.size();            // Courses made ready now wait a semester
+        if (maxPerSemester != 0) {
+            semesterEnd = min(semesterEnd, head + maxPerSemester);
+        }
+        for (; head < semesterEnd; head++) {
+            uint32_t course = ready[head];
+            courses.push_back(course);
+            for (size_t j = 0; j < graph.dependentCount(course); j++) {
+                uint32_t dependent = graph.dependents(course)[j];
+                if (!completed[dependent] && --remaining[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+        semesterStarts.push_back(static_cast<uint32_t>(courses.size()));
+    }
+    return toSchedule - courses.size();
+}
+
+//====================//
+// Course Name Search //
+//====================//
+
+/**
+ * Call onWord(begin, length) for each letter/digit run in text
+ */
+template <typename OnWord>
+static void forEachWord(string_view text, OnWord onWord) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isalnum(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        size_t start = i;
+        while (i < text.size() && isalnum(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        if (i > start) {
+            onWord(start, i - start);
+        }
+    }
+}
+
+/**
+ * Three bytes packed into one integer key
+ */
+static inline uint32_t packTrigram(const char* bytes) {
+    return (uint32_t(static_cast<unsigned char>(bytes[0])) << 16)
+        | (uint32_t(static_cast<unsigned char>(bytes[1])) << 8)
+        | uint32_t(static_cast<unsigned char>(bytes[2]));
+}
+
+/**
+ * Call onTrigram(key) for each trigram of a word, starting with the two that overlap a
+ * padded start ("  W" and " WO") so that even short words with a typo in the middle
+ * still share a trigram with the intended word. Padding is a space, which never
+ * occurs inside a word, so padded keys never match a substring probe.
+ */
+template <typename OnTrigram>
+static void forEachPaddedTrigram(string_view word, OnTrigram onTrigram) {
+    char padded[3] = { ' ', ' ', word.empty() ? ' ' : word[0] };
+    onTrigram(packTrigram(padded));
+    if (word.size() >= 2) {
+        padded[0] = ' ';
+        padded[1] = word[0];
+        padded[2] = word[1];
+        onTrigram(packTrigram(padded));
+    }
+    for (size_t i = 0; i + 3 <= word.size(); i++) {
+        onTrigram(packTrigram(word.data() + i));
+    }
+}
+
+/**
+ * Edit distance (insertions, deletions, substitutions and adjacent swaps) between a and b,
+ * or limit + 1 once it is certain to exceed limit. Words longer than 63 bytes never match.
+ */
+static int boundedEditDistance(string_view a, string_view b, int limit) {
+    int lengthGap = static_cast<int>(a.size()) - static_cast<int>(b.size());
+    if (a.size() > 63 || b.size() > 63 || abs(lengthGap) > limit) {
+        return limit + 1;
+    }
+    int rows[3][64];                     // Two rows back are needed for swaps
+    int* before = rows[0];
+    int* previous = rows[1];
+    int* current = rows[2];
+    for (size_t j = 0; j <= b.size(); j++) {
+        previous[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        current[0] = static_cast<int>(i);
+        int rowBest = current[0];
+        for (size_t j = 1; j <= b.size(); j++) {
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            int value = min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost });
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                value = min(value, before[j - 2] + 1);
+            }
+            current[j] = value;
+            rowBest = min(rowBest, value);
+        }
+        if (rowBest > limit) {
+            return limit + 1;            // Every alignment is already over the limit
+        }
+        int* recycled = before;
+        before = previous;
+        previous = current;
+        current = recycled;
+    }
+    return min(previous[b.size()], limit + 1);
+}
+
+/**
+ * Tokenize every course name and build the dictionary, postings and trigram lists
+ */
+NameIndex::NameIndex(CourseIterator first, CourseIterator last) {
+    // Pass 1: fold names, interning each word; pool IDs serve as provisional word IDs
+    vector<char> folded;
+    StringPool distinct;
+    vector<pair<uint32_t, uint32_t>> occurrences;     // (provisional word, course)
+    courseWordOffsets.push_back(0);
+    uint32_t course = 0;
+    for (CourseIterator it = first; it != last; ++it, course++) {
+        string_view name = (*it).name();
+        folded.resize(name.size());
+        for (size_t i = 0; i < name.size(); i++) {
+            char c = name[i];
+            folded[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        }
+        forEachWord(name, [&](size_t start, size_t length) {
+            occurrences.push_back({ distinct.intern(string_view(folded.data() + start, length)), course });
+        });
+        courseWordOffsets.push_back(static_cast<uint32_t>(occurrences.size()));
+    }
+
+    // Sort the dictionary and translate provisional IDs to final (sorted) word IDs
+    vector<uint32_t> sortedOrder(distinct.size());
+    for (uint32_t i = 0; i < sortedOrder.size(); i++) {
+        sortedOrder[i] = i;
+    }
+    sort(sortedOrder.begin(), sortedOrder.end(), [&](uint32_t a, uint32_t b) {
+        return distinct.view(a) < distinct.view(b);
+    });
+    vector<uint32_t> finalId(distinct.size());
+    wordStarts.push_back(0);
+    for (uint32_t rank = 0; rank < sortedOrder.size(); rank++) {
+        string_view text = distinct.view(sortedOrder[rank]);
+        finalId[sortedOrder[rank]] = rank;
+        wordText.insert(wordText.end(), text.begin(), text.end());
+        wordStarts.push_back(static_cast<uint32_t>(wordText.size()));
+    }
+
+    // Forward lists: each course's word IDs, sorted and de-duplicated
+    courseWords.reserve(occurrences.size());
+    for (size_t c = 0; c + 1 < courseWordOffsets.size(); c++) {
+        size_t listStart = courseWords.size();
+        for (uint32_t i = courseWordOffsets[c]; i < courseWordOffsets[c + 1]; i++) {
+            courseWords.push_back(finalId[occurrences[i].first]);
+        }
+        sort(courseWords.begin() + listStart, courseWords.end());
+        courseWords.erase(unique(courseWords.begin() + listStart, courseWords.end()), courseWords.end());
+        courseWordOffsets[c] = static_cast<uint32_t>(listStart);
+    }
+    courseWordOffsets.back() = static_cast<uint32_t>(courseWords.size());
+
+    // Posting lists by counting sort; courses arrive in ID order, so each list is sorted
+    postingOffsets.assign(wordCount() + 1, 0);
+    for (uint32_t w : courseWords) {
+        postingOffsets[w + 1]++;
+    }
+    for (size_t w = 0; w < wordCount(); w++) {
+        postingOffsets[w + 1] += postingOffsets[w];
+    }
+    postings.resize(courseWords.size());
+    vector<uint32_t> cursor(postingOffsets.begin(), postingOffsets.end() - 1);
+    for (uint32_t c = 0; c + 1 < courseWordOffsets.size(); c++) {
+        for (uint32_t i = courseWordOffsets[c]; i < courseWordOffsets[c + 1]; i++) {
+            postings[cursor[courseWords[i]]++] = c;
+        }
+    }
+
+    // Trigram lists: (trigram, word) pairs for every distinct trigram of every word
+    vector<pair<uint32_t, uint32_t>> trigrams;
+    for (uint32_t w = 0; w < wordCount(); w++) {
+        size_t listStart = trigrams.size();
+        forEachPaddedTrigram(word(w), [&](uint32_t key) { trigrams.push_back({ key, w }); });
+        sort(trigrams.begin() + listStart, trigrams.end());
+        trigrams.erase(unique(trigrams.begin() + listStart, trigrams.end()), trigrams.end());
+    }
+    sort(trigrams.begin(), trigrams.end());
+    trigramWords.reserve(trigrams.size());
+    for (size_t i = 0; i < trigrams.size(); i++) {
+        if (i == 0 || trigrams[i].first != trigrams[i - 1].first) {
+            trigramKeys.push_back(trigrams[i].first);
+            trigramOffsets.push_back(static_cast<uint32_t>(i));
+        }
+        trigramWords.push_back(trigrams[i].second);
+    }
+    trigramOffsets.push_back(static_cast<uint32_t>(trigrams.size()));
+}
+
+/**
+ * Words containing a trigram (count is set to 0 if no word does)
+ */
+const uint32_t* NameIndex::trigramPostings(uint32_t key, size_t& count) const {
+    auto position = std::lower_bound(trigramKeys.begin(), trigramKeys.end(), key);
+    if (position == trigramKeys.end() || *position != key) {
+        count = 0;
+        return nullptr;
+    }
+    size_t t = position - trigramKeys.begin();
+    count = trigramOffsets[t + 1] - trigramOffsets[t];
+    return trigramWords.data() + trigramOffsets[t];
+}
+
+/**
+ * Every dictionary word one (uppercase) query term matches, with its score
+ * Terms of three or more bytes match anywhere inside a word, found through the term's
+ * rarest trigram; shorter terms match word prefixes through the sorted dictionary. A
+ * term with no such match falls back to words within a small edit distance of it.
+ */
+NameIndex::TermMatches NameIndex::matchTerm(string_view term) const {
+    TermMatches matches;
+    auto scoreOf = [&](string_view text) {
+        if (text == term) return EXACT_SCORE;
+        return text.substr(0, term.size()) == term ? PREFIX_SCORE : SUBSTRING_SCORE;
+    };
+
+    if (term.size() < 3) {
+        // Words starting with term are contiguous and begin at the first word >= term
+        size_t low = 0;
+        size_t high = wordCount();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (word(static_cast<uint32_t>(middle)) < term) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        for (uint32_t w = static_cast<uint32_t>(low); w < wordCount() && word(w).substr(0, term.size()) == term; w++) {
+            matches.push_back({ w, scoreOf(word(w)) });
+        }
+        return matches;
+    }
+
+    // Substring: verify the words holding the term's rarest trigram
+    const uint32_t* rarest = nullptr;
+    size_t rarestCount = SIZE_MAX;
+    for (size_t i = 0; i + 3 <= term.size(); i++) {
+        size_t count;
+        const uint32_t* words = trigramPostings(packTrigram(term.data() + i), count);
+        if (count < rarestCount) {
+            rarest = words;
+            rarestCount = count;
+        }
+    }
+    for (size_t i = 0; i < rarestCount; i++) {
+        string_view text = word(rarest[i]);
+        if (text.find(term) != string_view::npos) {
+            matches.push_back({ rarest[i], scoreOf(text) });
+        }
+    }
+    if (!matches.empty() || term.size() < 4) {
+        return matches;
+    }
+
+    // Typo tolerance: candidates share enough (start-padded) trigrams to be within the
+    // edit limit - one edit or swap changes at most four - and at least one; each is then
+    // verified against both the whole word and its prefix of the term's length
+    int limit = term.size() <= 5 ? 1 : 2;
+    int needed = max(1, static_cast<int>(term.size()) - 4 * limit); // term.size() trigrams with padding
+    vector<uint32_t> keys;
+    forEachPaddedTrigram(term, [&](uint32_t key) { keys.push_back(key); });
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    unordered_map<uint32_t, int> shared;
+    for (uint32_t key : keys) {
+        size_t count;
+        const uint32_t* words = trigramPostings(key, count);
+        for (size_t j = 0; j < count; j++) {
+            shared[words[j]]++;
+        }
+    }
+    for (const auto& candidate : shared) {
+        if (candidate.second < needed) {
+            continue;
+        }
+        string_view text = word(candidate.first);
+        int edits = min(boundedEditDistance(term, text, limit),
+            boundedEditDistance(term, text.substr(0, term.size()), limit));
+        if (edits <= limit) {
+            matches.push_back({ candidate.first, TYPO_SCORE / edits });
+        }
+    }
+    sort(matches.begin(), matches.end());
+    return matches;
+}
+
+/**
+ * Ranked search over course names. Every query term must match a word of the course
+ * (as a whole word, prefix, substring or near-miss); a course scores the sum of its best
+ * match per term, and ties go to the course that sorts first.
+ *
+ * The term with the fewest postings drives the search. Its matching words are taken one
+ * score tier at a time, best tier first, and within a tier their posting lists are merged
+ * in course order; each course reached is checked against the other terms through its
+ * own short word list. Because no later course can then beat the current top results,
+ * the scan stops as soon as the limit-th best score reaches the best score still possible
+ * - so broad queries read only the front of their posting lists.
+ */
+vector<NameMatch> NameIndex::search(string_view query, size_t limit) const {
+    FoldedKey folded(query);
+    vector<TermMatches> terms;
+    vector<size_t> postingTotals;
+    forEachWord(folded.view(), [&](size_t start, size_t length) {
+        terms.push_back(matchTerm(folded.view().substr(start, length)));
+        size_t total = 0;
+        for (const auto& match : terms.back()) {
+            total += postingOffsets[match.first + 1] - postingOffsets[match.first];
+        }
+        postingTotals.push_back(total);
+    });
+    vector<NameMatch> best;               // Top results so far, best first
+    if (terms.empty() || limit == 0) {
+        return best;
+    }
+    size_t driver = min_element(postingTotals.begin(), postingTotals.end()) - postingTotals.begin();
+
+    // Best score each term can still add, for the stopping bound
+    float othersMax = 0;
+    for (size_t t = 0; t < terms.size(); t++) {
+        float termMax = 0;
+        for (const auto& match : terms[t]) {
+            termMax = max(termMax, match.second);
+        }
+        othersMax += t == driver ? 0 : termMax;
+    }
+
+    auto better = [](const NameMatch& a, const NameMatch& b) {
+        return a.score != b.score ? a.score > b.score : a.course < b.course;
+    };
+
+    // Best score a course's words give one term (0 if none of them match it)
+    auto termScore = [&](const TermMatches& matches, uint32_t course) {
+        float score = 0;
+        for (uint32_t i = courseWordOffsets[course]; i < courseWordOffsets[course + 1]; i++) {
+            auto found = std::lower_bound(matches.begin(), matches.end(), make_pair(courseWords[i], -1.0f));
+            if (found != matches.end() && found->first == courseWords[i]) {
+                score = max(score, found->second);
+            }
+        }
+        return score;
+    };
+
+    // Driver words grouped into tiers of equal score, best tier first
+    TermMatches tiers = terms[driver];
+    stable_sort(tiers.begin(), tiers.end(), [](const pair<uint32_t, float>& a, const pair<uint32_t, float>& b) {
+        return a.second > b.second;
+    });
+
+    struct Cursor {
+        uint32_t course;                              // Course at position
+        uint32_t position;                            // Next entry of one posting list
+        uint32_t end;                                 // End of that list
+    };
+    vector<Cursor> heap;
+    for (size_t tierStart = 0; tierStart < tiers.size();) {
+        float tierScore = tiers[tierStart].second;
+        size_t tierEnd = tierStart;
+        while (tierEnd < tiers.size() && tiers[tierEnd].second == tierScore) {
+            tierEnd++;
+        }
+        float bound = tierScore + othersMax;          // Best total any course in this tier can reach
+        if (best.size() == limit && best.back().score > bound) {
+            break;                                    // Neither this tier nor a later one can place
+        }
+
+        // Merge the tier's posting lists (each sorted by course) with a min-heap of cursors
+        heap.clear();
+        for (size_t w = tierStart; w < tierEnd; w++) {
+            uint32_t word = tiers[w].first;
+            if (postingOffsets[word] < postingOffsets[word + 1]) {
+                heap.push_back({ postings[postingOffsets[word]], postingOffsets[word], postingOffsets[word + 1] });
+            }
+        }
+        auto later = [](const Cursor& a, const Cursor& b) { return a.course > b.course; };
+        make_heap(heap.begin(), heap.end(), later);
+        long previous = -1;
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), later);
+            uint32_t course = heap.back().course;
+            if (++heap.back().position < heap.back().end) {
+                heap.back().course = postings[heap.back().position];
+                push_heap(heap.begin(), heap.end(), later);
+            }
+            else {
+                heap.pop_back();                      // This word's list is used up
+            }
+            if (static_cast<long>(course) == previous) {
+                continue;                             // Also reached through another word of this tier
+            }
+            previous = course;
+
+            if (best.size() == limit && (best.back().score > bound
+                || (best.back().score == bound && best.back().course < course))) {
+                break;                                // Later courses in this tier cannot place
+            }
+            if (termScore(terms[driver], course) != tierScore) {
+                continue;                             // Scored in a better tier already
+            }
+            float total = tierScore;
+            for (size_t t = 0; t < terms.size() && total > 0; t++) {
+                if (t != driver) {
+                    float score = termScore(terms[t], course);
+                    total = score > 0 ? total + score : 0;
+                }
+            }
+            if (total <= 0) {
+                continue;
+            }
+            NameMatch match = { course, total };
+            if (best.size() < limit || better(match, best.back())) {
+                best.insert(upper_bound(best.begin(), best.end(), match, better), match);
+                if (best.size() > limit) {
+                    best.pop_back();
+                }
+            }
+        }
+        tierStart = tierEnd;
+    }
+    return best;
+}
+
+//=================//
+// Instrumentation //
+//=================//
+
+/**
+ * Phases of a catalog load, in order
+ */
+enum LoadPhase {
+    PHASE_READ,          // Open and map the file (or attach a snapshot)
+    PHASE_SPLIT,         // Tokenize lines into course records
+    PHASE_VALIDATE,      // Check prerequisites and build the valid courses
+    PHASE_INSERT,        // Put the courses into the tree
+    PHASE_INDEX,         // Prerequisite graph and course name index
+    PHASE_COUNT
+};
+
+static const char* const LOAD_PHASE_NAMES[PHASE_COUNT] = { "read", "split", "validate", "insert", "index" };
+
+#ifdef ABCU_ENABLE_STATS
+/**
+ * Process-wide instrumentation counters (only compiled with ABCU_ENABLE_STATS)
+ * Everything is atomic and updated with relaxed ordering, so instrumented paths may run
+ * on any thread; every member is constant-initialized, so the counting operator new can
+ * use it before any constructor has run.
+ */
+struct Statistics {
+    static const int LATENCY_BUCKETS = 40;        // Bucket b: lookups taking [2^b, 2^(b+1)) ns
+
+    atomic<uint64_t> allocations{ 0 };            // operator new calls since start-up
+    atomic<uint64_t> allocatedBytes{ 0 };
+    atomic<uint64_t> loads{ 0 };                  // Completed catalog loads
+    atomic<uint64_t> phaseNanoseconds[PHASE_COUNT] = {}; // Last load, per phase
+    atomic<uint64_t> phaseAllocations[PHASE_COUNT] = {};
+    atomic<uint64_t> phaseBytes[PHASE_COUNT] = {};
+    atomic<uint64_t> searches{ 0 };               // Find() calls (Search and Contains go through it)
+    atomic<uint64_t> searchNanoseconds{ 0 };
+    atomic<uint64_t> searchLatency[LATENCY_BUCKETS] = {};
+};
+
+static Statistics statistics;
+
+/**
+ * Counting replacements for the global allocation functions (array forms forward here)
+ * Kept out of line so the compiler never pairs an inlined malloc/free with new/delete.
+ * The align_val_t forms are replaced too: the frozen index's keys and the closure bitset
+ * are over-aligned and would otherwise bypass the counters.
+ */
+ABCU_NOINLINE void* operator new(size_t bytes) {
+    statistics.allocations.fetch_add(1, memory_order_relaxed);
+    statistics.allocatedBytes.fetch_add(bytes, memory_order_relaxed);
+    if (void* memory = malloc(bytes > 0 ? bytes : 1)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+ABCU_NOINLINE void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+ABCU_NOINLINE void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+ABCU_NOINLINE void* operator new(size_t bytes, align_val_t alignment) {
+    statistics.allocations.fetch_add(1, memory_order_relaxed);
+    statistics.allocatedBytes.fetch_add(bytes, memory_order_relaxed);
+    size_t boundary = max(static_cast<size_t>(alignment), sizeof(void*)); // posix_memalign's minimum
+#ifdef _WIN32
+    void* memory = _aligned_malloc(bytes > 0 ? bytes : 1, boundary);
+#else
+    void* memory = nullptr;
+    if (posix_memalign(&memory, boundary, bytes > 0 ? bytes : 1) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (memory != nullptr) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+ABCU_NOINLINE void operator delete(void* memory, align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(memory);    // _aligned_malloc blocks cannot go to free()
+#else
+    free(memory);
+#endif
+}
+
+ABCU_NOINLINE void operator delete(void* memory, size_t, align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
+
+/**
+ * Times the phases of one load; entering a phase ends the previous one
+ * Starting a profiler clears the previous load's figures
+ */
+class LoadProfiler {
+private:
+    LoadPhase phase;
+    chrono::steady_clock::time_point start;
+    uint64_t allocationsAtStart;
+    uint64_t bytesAtStart;
+    bool running;
+
+public:
+    LoadProfiler() : phase(PHASE_READ), allocationsAtStart(0), bytesAtStart(0), running(false) {
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            statistics.phaseNanoseconds[i].store(0, memory_order_relaxed);
+            statistics.phaseAllocations[i].store(0, memory_order_relaxed);
+            statistics.phaseBytes[i].store(0, memory_order_relaxed);
+        }
+    }
+    ~LoadProfiler() {
+        finish();
+        statistics.loads.fetch_add(1, memory_order_relaxed);
+    }
+
+    void enter(LoadPhase next) {
+        finish();
+        phase = next;
+        running = true;
+        allocationsAtStart = statistics.allocations.load(memory_order_relaxed);
+        bytesAtStart = statistics.allocatedBytes.load(memory_order_relaxed);
+        start = chrono::steady_clock::now();
+    }
+
+    void finish() {
+        if (!running) {
+            return;
+        }
+        chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+        statistics.phaseNanoseconds[phase].fetch_add(static_cast<uint64_t>(elapsed.count()), memory_order_relaxed);
+        statistics.phaseAllocations[phase].fetch_add(
+            statistics.allocations.load(memory_order_relaxed) - allocationsAtStart, memory_order_relaxed);
+        statistics.phaseBytes[phase].fetch_add(
+            statistics.allocatedBytes.load(memory_order_relaxed) - bytesAtStart, memory_order_relaxed);
+        running = false;
+    }
+};
+
+/**
+ * Records the latency of one lookup into the histogram when it goes out of scope
+ */
+class SearchTimer {
+private:
+    chrono::steady_clock::time_point start;
+
+public:
+    SearchTimer() : start(chrono::steady_clock::now()) {}
+    ~SearchTimer() {
+        chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+        uint64_t nanoseconds = static_cast<uint64_t>(elapsed.count());
+        int bucket = 0;
+        while (bucket < Statistics::LATENCY_BUCKETS - 1 && (nanoseconds >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        statistics.searches.fetch_add(1, memory_order_relaxed);
+        statistics.searchNanoseconds.fetch_add(nanoseconds, memory_order_relaxed);
+        statistics.searchLatency[bucket].fetch_add(1, memory_order_relaxed);
+    }
+};
+
+#define ABCU_STATS_LOAD() LoadProfiler loadProfiler
+#define ABCU_STATS_PHASE(phase) loadProfiler.enter(phase)
+#define ABCU_STATS_SEARCH() SearchTimer searchTimer
+#else
+#define ABCU_STATS_LOAD() ((void)0)          // Instrumentation compiled out
+#define ABCU_STATS_PHASE(phase) ((void)0)
+#define ABCU_STATS_SEARCH() ((void)0)
+#endif
+
+//=======================//
+// AVL Balancing Helpers //
+//=======================//
+
+/**
+ * Height of a possibly empty subtree
+ */
+static int nodeHeight(Node* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+/**
+ * Number of nodes in a possibly empty subtree
+ */
+static int nodeSize(Node* node) {
+    return node == nullptr ? 0 : node->size;
+}
+
+/**
+ * Recompute a node's height and subtree size from its children, and point the children
+ * back at it. Every node whose children change passes through here (inserts, rotations
+ * and balanced builds), so parent links stay correct without extra bookkeeping.
+ */
+static void updateNode(Node* node) {
+    node->height = 1 + max(nodeHeight(node->left), nodeHeight(node->right));
+    node->size = 1 + nodeSize(node->left) + nodeSize(node->right);
+    if (node->left != nullptr) node->left->parent = node;
+    if (node->right != nullptr) node->right->parent = node;
+}
+
+/**
+ * Rotate right around node - the left child becomes the new subtree root
+ */
+static Node* rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    updateNode(node);       // Old root is now below the pivot, so update it first
+    updateNode(pivot);
+    return pivot;
+}
+
+/**
+ * Rotate left around node - the right child becomes the new subtree root
+ */
+static Node* rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    updateNode(node);
+    updateNode(pivot);
+    return pivot;
+}
+
+/**
+ * Restore the AVL property at node (children heights differ by at most 1)
+ * Returns the new root of this subtree
+ */
+static Node* rebalance(Node* node) {
+    updateNode(node);
+    int balance = nodeHeight(node->left) - nodeHeight(node->right);
+
+    if (balance > 1) {                                        // Left side too tall
+        if (nodeHeight(node->left->left) < nodeHeight(node->left->right)) {
+            node->left = rotateLeft(node->left);              // Left-right case
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {                                       // Right side too tall
+        if (nodeHeight(node->right->right) < nodeHeight(node->right->left)) {
+            node->right = rotateRight(node->right);           // Right-left case
+        }
+        return rotateLeft(node);
+    }
+    return node;                                              // Already balanced
+}
+
+/**
+ * Default constructor - Initializes an empty binary search tree with null root pointer
+ * Balanced mode (default) keeps the tree an AVL tree so sorted input cannot degrade it
+ * into a linked list; pass false for the plain unbalanced behavior
+ */
+BinarySearchTree::BinarySearchTree(bool balancedMode) {
+    root = nullptr;                     // Start with empty tree - no nodes
+    freeNodes = nullptr;
+    deadStringBytes = 0;
+    balanced = balancedMode;
+}
+
+/**
+ * Destructor - Frees all dynamically allocated memory when tree is destroyed
+ */
+BinarySearchTree::~BinarySearchTree() { 
+    destroyTree();                      // Arena and string pool free their blocks
+}
+
+/**
+ * Destroy tree to free memory
+ * Nodes hold no owned memory, so there is nothing to visit: the node arena releases
+ * all of its blocks at once (and a degenerate tree cannot overflow the call stack)
+ */
+void BinarySearchTree::destroyTree() {
+    nodeArena.release();
+    root = nullptr;
+    freeNodes = nullptr;          // They lived in the arena too
+}
+
+/**
+ * Allocate and construct a node, reusing one freed by Remove() before touching the arena
+ * (the arena cannot give single nodes back, so churn would otherwise grow it forever)
+ */
+Node* BinarySearchTree::newNode(const StoredCourse& course) {
+    void* memory;
+    if (freeNodes != nullptr) {
+        memory = freeNodes;
+        freeNodes = freeNodes->left;
+    }
+    else {
+        memory = nodeArena.allocate(sizeof(Node), alignof(Node));
+    }
+    return new (memory) Node(course);
+}
+
+/**
+ * Insert a course into the tree
+ * The course is taken by reference - its strings are copied straight into the pool
+ */
+void BinarySearchTree::Insert(const Course& course) {
+    thaw();                       // Snapshots and frozen indexes are read-only - switch to nodes first
+    dropIndexes();                // They describe the old contents
+    StoredCourse stored = storeCourse(course, strings); // Intern strings into the tree's pool
+	if (root == nullptr) {        // If tree is empty..
+		root = newNode(stored);   // Create a new node with the course and set it as the root
+    }
+    else {                        // If tree already has nodes..
+        addNode(root, stored);    // Call helper to find insertion point
+    }
+}
+
+/**
+ * Insert a course given as views (e.g. straight out of a mapped file)
+ * Nothing is materialized outside the tree's own pool
+ */
+void BinarySearchTree::Emplace(string_view courseNumber, string_view courseName,
+    const string_view* prerequisites, size_t prerequisiteCount) {
+    thaw();
+    dropIndexes();
+    StoredCourse stored = storeCourseViews(courseNumber, courseName,
+        prerequisites, prerequisiteCount, strings);
+    if (root == nullptr) {
+        root = newNode(stored);
+    }
+    else {
+        addNode(root, stored);
+    }
+}
+
+/**
+ * Remove a course by course number (case-insensitive)
+ * The course's strings stay in the pool - other courses may share the interned number -
+ * and are counted as dead until Freeze() compacts the pool
+ */
+bool BinarySearchTree::Remove(string_view courseNumber) {
+    FoldedKey key(courseNumber);
+    CourseRef current = Find(key.view());
+    if (!current) {
+        return false;             // Nothing to do - and no reason to thaw a frozen tree
+    }
+    if (!snapshot) {              // Mapped strings were never in the pool
+        deadStringBytes += current.name().size() + current.prerequisiteCount() * sizeof(uint32_t);
+    }
+    thaw();
+    dropIndexes();
+    removeNode(key.view());
+    return true;
+}
+
+/**
+ * Replace the name and prerequisites of an existing course (false if it does not exist)
+ * The course keeps its rank, so only an index whose input changed is discarded: the graph
+ * when the prerequisites differ, the name index when the name does. A frozen index is
+ * patched in place rather than thawed.
+ */
+bool BinarySearchTree::Update(string_view courseNumber, string_view courseName,
+    const string_view* prerequisites, size_t prerequisiteCount) {
+    FoldedKey key(courseNumber);
+    CourseRef current = Find(key.view());
+    if (!current) {
+        return false;
+    }
+    bool samePrerequisites = current.prerequisiteCount() == prerequisiteCount;
+    for (size_t i = 0; samePrerequisites && i < prerequisiteCount; i++) {
+        samePrerequisites = current.prerequisite(i) == prerequisites[i];
+    }
+    if (!samePrerequisites) {
+        graph.reset();
+    }
+    if (current.name() != courseName) {
+        names.reset();
+    }
+    if (!snapshot) {              // The old name and ID list stay behind in the pool
+        deadStringBytes += current.name().size() + current.prerequisiteCount() * sizeof(uint32_t);
+    }
+
+    if (snapshot) {
+        thaw();                   // Mapped courses are read-only (a frozen index is patched instead)
+    }
+    StoredCourse stored = storeCourseViews(key.view(), courseName,
+        prerequisites, prerequisiteCount, strings);
+    if (frozen) {
+        frozen->replace(static_cast<size_t>(frozen->find(key.view())), stored);
+    }
+    else {
+        addNode(root, stored);    // Existing key - the node's course is replaced, shape unchanged
+    }
+    return true;
+}
+
+/**
+ * Unlink the node holding courseNumber (which must exist)
+ * A node with two children takes over its in-order successor's course and the successor's
+ * node is unlinked instead; it has no left child, so it is spliced out directly. The path
+ * is then walked back up like addNode() does, shrinking sizes and rebalancing.
+ */
+void BinarySearchTree::removeNode(string_view courseNumber) {
+    vector<Node**> path;          // Links from the root down to the removed node's parent
+    Node** link = &root;
+    PackedKey probe = packKey(courseNumber);
+    int order;
+    while ((order = compareKeys(probe, courseNumber, (*link)->key, (*link)->course.courseNumber)) != 0) {
+        path.push_back(link);
+        link = order < 0 ? &(*link)->left : &(*link)->right;
+    }
+
+    Node* target = *link;
+    if (target->left != nullptr && target->right != nullptr) {
+        path.push_back(link);
+        Node** successor = &target->right;
+        while ((*successor)->left != nullptr) {
+            path.push_back(successor);
+            successor = &(*successor)->left;
+        }
+        target->key = (*successor)->key;
+        target->course = (*successor)->course;
+        link = successor;
+        target = *successor;
+    }
+    *link = target->left != nullptr ? target->left : target->right;
+    if (*link != nullptr) {
+        (*link)->parent = target->parent;
+    }
+    target->left = freeNodes;     // Keep the node for the next insert
+    freeNodes = target;
+
+    // Every ancestor lost a node, so the walk goes all the way to the root
+    for (size_t i = path.size(); i-- > 0;) {
+        Node** ancestor = path[i];
+        if (balanced) {
+            *ancestor = rebalance(*ancestor);
+        }
+        else {
+            updateNode(*ancestor);
+        }
+    }
+    if (root != nullptr) {
+        root->parent = nullptr;
+    }
+}
+
+/**
+ * Add a course below some node
+ * Walks down iteratively, remembering every link taken, then walks back up the
+ * path to update heights and subtree sizes and (in balanced mode) rebalance each ancestor
+ */
+void BinarySearchTree::addNode(Node* node, const StoredCourse& course) {
+    vector<Node**> path;          // Links from the root down to the insertion point
+    Node** link = &root;
+    PackedKey key = packKey(course.courseNumber);
+
+    while (*link != nullptr) {
+        node = *link;
+        // Compare course numbers to determine insert position
+        int order = compareKeys(key, course.courseNumber, node->key, node->course.courseNumber);
+        if (order < 0) {
+            path.push_back(link);
+            link = &node->left;   // Course number is smaller - continue in left subtree
+        }
+        else if (order > 0) {
+            path.push_back(link);
+            link = &node->right;  // Course number is larger - continue in right subtree
+        }
+        else {
+            // Course already exists - update it with new data (tree shape unchanged)
+            node->course = course;
+            return;
+        }
+    }
+
+    *link = newNode(course);      // Insert new node at the empty position found
+
+    // Walk back up the path, fixing heights and sizes and restoring balance
+    // (every ancestor gained a node, so the walk always goes all the way to the root)
+    for (size_t i = path.size(); i-- > 0;) {
+        Node** ancestor = path[i];
+        if (balanced) {
+            *ancestor = rebalance(*ancestor);
+        }
+        else {
+            updateNode(*ancestor);
+        }
+    }
+    root->parent = nullptr;       // A rotation at the top may have produced a new root
+}
+
+/**
+ * Replace the tree contents with a perfectly balanced tree built from courses in O(n)
+ * The vector is sorted by course number first (a no-op check when input is already
+ * sorted); for duplicate course numbers the last one wins, matching Insert()
+ * The vector is left sorted and de-duplicated; its strings are copied into the tree's pool
+ */
+void BinarySearchTree::BuildBalanced(vector<Course>& courses) {
+    destroyTree();
+    strings.clear();              // Nothing refers to the old strings any more
+    deadStringBytes = 0;
+    snapshot.reset();             // New contents replace any attached snapshot or frozen index
+    frozen.reset();
+    dropIndexes();
+
+    auto byNumber = [](const Course& a, const Course& b) {
+        return a.courseNumber < b.courseNumber;
+    };
+    if (!is_sorted(courses.begin(), courses.end(), byNumber)) {
+        stable_sort(courses.begin(), courses.end(), byNumber);
+    }
+
+    // Collapse duplicates, keeping the last occurrence of each course number
+    size_t unique = 0;
+    for (size_t i = 0; i < courses.size(); i++) {
+        if (unique > 0 && courses[unique - 1].courseNumber == courses[i].courseNumber) {
+            courses[unique - 1] = move(courses[i]);
+        }
+        else {
+            if (unique != i) {
+                courses[unique] = move(courses[i]);
+            }
+            unique++;
+        }
+    }
+    courses.resize(unique);
+
+    vector<StoredCourse> stored;
+    stored.reserve(courses.size());
+    for (const Course& course : courses) {
+        stored.push_back(storeCourse(course, strings));
+    }
+    root = buildRange(stored, 0, stored.size());
+}
+
+/**
+ * Build a balanced subtree from sorted courses[first, last) - middle element becomes the root
+ * Recursion depth is only log2(n) because each call halves the range
+ */
+Node* BinarySearchTree::buildRange(const vector<StoredCourse>& courses, size_t first, size_t last) {
+    if (first >= last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2;
+    Node* node = newNode(courses[middle]);
+    node->left = buildRange(courses, first, middle);
+    node->right = buildRange(courses, middle + 1, last);
+    updateNode(node);
+    return node;
+}
+
+/**
+ * Search for a course by course number
+ * Returns an owning copy (an empty course if not found); use Find() to avoid the copy
+ */
+Course BinarySearchTree::Search(string courseNumber) {
+    CourseRef course = Find(courseNumber);
+    return course ? course.toCourse() : Course();
+}
+
+/**
+ * Find a course by course number without copying it
+ * The key is case-folded into a stack buffer, then looked up in whichever layout is
+ * active: frozen index, mapped snapshot or node tree. No heap allocation takes place.
+ */
+CourseRef BinarySearchTree::Find(string_view courseNumber) const {
+    ABCU_STATS_SEARCH();          // Latency histogram (compiled out unless ABCU_ENABLE_STATS)
+    FoldedKey key(courseNumber);  // Uppercase search key for case-insensitive search
+    string_view folded = key.view();
+
+    // Frozen tree: Eytzinger search over the compact key array
+    if (frozen) {
+        long rank = frozen->find(folded);
+        return rank < 0 ? CourseRef() : CourseRef(&frozen->at(static_cast<size_t>(rank)), &strings);
+    }
+
+    // Snapshot-backed tree: binary search the mapped course array
+    if (snapshot) {
+        long index = snapshot->find(folded);
+        return index < 0 ? CourseRef() : CourseRef(snapshot.get(), static_cast<size_t>(index));
+    }
+
+    Node* current = root; // Start searching from the root
+    PackedKey probe = packKey(folded);
+
+    // Continue searching while we haven't reached a leaf
+    while (current != nullptr) {
+        int order = compareKeys(probe, folded, current->key, current->course.courseNumber);
+        if (order == 0) {
+            return CourseRef(&current->course, &strings); // Found it!
+        }
+        // Search key is smaller - go left; larger - go right
+        current = order < 0 ? current->left : current->right;
+    }
+
+    return CourseRef();   // Not found
+}
+
+/**
+ * Look up many course numbers together (e.g. a transcript or degree audit)
+ * Keys are folded, sorted and de-duplicated, then resolved as a group: the frozen index
+ * interleaves prefetched descents, a snapshot gallops forward from the previous match,
+ * and a node tree either descends per key or - when that would visit more nodes than the
+ * tree has - merges the keys with one in-order walk. Results come back in input order
+ * (an empty CourseRef for each key that is not found).
+ */
+vector<CourseRef> BinarySearchTree::FindMany(const string_view* courseNumbers, size_t count) const {
+    // Fold every key into one buffer, then sort positions by key
+    vector<char> folded;
+    vector<size_t> starts(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        starts[i + 1] = starts[i] + courseNumbers[i].size();
+    }
+    folded.resize(starts[count]);
+    vector<string_view> keys(count);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < courseNumbers[i].size(); j++) {
+            char c = courseNumbers[i][j];
+            folded[starts[i] + j] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        }
+        keys[i] = string_view(folded.data() + starts[i], courseNumbers[i].size());
+    }
+    vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    // Distinct keys in ascending order, and which distinct key each input maps to
+    vector<string_view> unique;
+    vector<uint32_t> slotOf(count);
+    for (uint32_t input : order) {
+        if (unique.empty() || unique.back() != keys[input]) {
+            unique.push_back(keys[input]);
+        }
+        slotOf[input] = static_cast<uint32_t>(unique.size() - 1);
+    }
+
+    vector<CourseRef> resolved(unique.size());
+    if (frozen) {
+        vector<long> ranks(unique.size());
+        frozen->findBatch(unique.data(), unique.size(), ranks.data());
+        for (size_t i = 0; i < unique.size(); i++) {
+            if (ranks[i] >= 0) {
+                resolved[i] = CourseRef(&frozen->at(static_cast<size_t>(ranks[i])), &strings);
+            }
+        }
+    }
+    else if (snapshot) {
+        size_t position = 0;                  // Ascending keys never need to look back
+        for (size_t i = 0; i < unique.size(); i++) {
+            position = snapshot->lowerBoundFrom(unique[i], position);
+            if (position < snapshot->size() && snapshot->number(position) == unique[i]) {
+                resolved[i] = CourseRef(snapshot.get(), position);
+            }
+        }
+    }
+    else if (unique.size() * static_cast<size_t>(nodeHeight(root)) > static_cast<size_t>(nodeSize(root))) {
+        // Dense batch: one merged in-order walk over tree and keys
+        const Node* node = firstNode(root);
+        size_t i = 0;
+        PackedKey probe = unique.empty() ? PackedKey() : packKey(unique[0]);
+        while (node != nullptr && i < unique.size()) {
+            int order = compareKeys(probe, unique[i], node->key, node->course.courseNumber);
+            if (order == 0) {
+                resolved[i++] = CourseRef(&node->course, &strings);
+                node = nextNode(node);
+                probe = i < unique.size() ? packKey(unique[i]) : probe;
+            }
+            else if (order < 0) {
+                i++;                          // Key sorts before this node - not in the tree
+                probe = i < unique.size() ? packKey(unique[i]) : probe;
+            }
+            else {
+                node = nextNode(node);
+            }
+        }
+    }
+    else {
+        // Eight descents in lockstep, each prefetching its next node (sorted keys also keep
+        // the shared upper levels cached)
+        const size_t LANES = 8;
+        const Node* lanes[LANES];
+        PackedKey probes[LANES];
+        for (size_t base = 0; base < unique.size(); base += LANES) {
+            size_t active = min(LANES, unique.size() - base);
+            for (size_t lane = 0; lane < active; lane++) {
+                lanes[lane] = root;
+                probes[lane] = packKey(unique[base + lane]);
+            }
+            bool descending = true;
+            while (descending) {
+                descending = false;
+                for (size_t lane = 0; lane < active; lane++) {
+                    const Node* current = lanes[lane];
+                    if (current == nullptr) {
+                        continue;
+                    }
+                    int order = compareKeys(probes[lane], unique[base + lane], current->key, current->course.courseNumber);
+                    if (order == 0) {
+                        resolved[base + lane] = CourseRef(&current->course, &strings);
+                        lanes[lane] = nullptr;
+                        continue;
+                    }
+                    current = order < 0 ? current->left : current->right;
+                    if (current != nullptr) {
+                        ABCU_PREFETCH(current);
+                        descending = true;
+                    }
+                    lanes[lane] = current;
+                }
+            }
+        }
+    }
+
+    // Scatter back to input order
+    vector<CourseRef> results(count);
+    for (size_t i = 0; i < count; i++) {
+        results[i] = resolved[slotOf[i]];
+    }
+    return results;
+}
+
+/**
+ * Print all courses in alphanumeric order
+ */
+void BinarySearchTree::PrintCourseList() const {
+    cout << "Here is a sample schedule:" << endl << endl;
+    for (CourseRef course : *this) {  // In-order walk - no recursion or stack in any layout
+        cout << course.number() << ", " << course.name() << endl;
+    }
+}
+
+/**
+ * Iterator at the first course in alphanumeric order
+ */
+CourseIterator BinarySearchTree::begin() const {
+    if (frozen) {
+        return CourseIterator(frozen.get(), 0, &strings);
+    }
+    if (snapshot) {
+        return CourseIterator(snapshot.get(), 0);
+    }
+    return CourseIterator(firstNode(root), root, &strings);
+}
+
+/**
+ * Iterator one past the last course
+ */
+CourseIterator BinarySearchTree::end() const {
+    if (frozen) {
+        return CourseIterator(frozen.get(), frozen->size(), &strings);
+    }
+    if (snapshot) {
+        return CourseIterator(snapshot.get(), snapshot->size());
+    }
+    return CourseIterator(nullptr, root, &strings);
+}
+
+/**
+ * First course whose number is not less than the key (case-insensitive), or end()
+ */
+CourseIterator BinarySearchTree::lower_bound(string_view courseNumber) const {
+    FoldedKey key(courseNumber);
+    string_view folded = key.view();
+    if (frozen) {
+        return CourseIterator(frozen.get(), frozen->lowerBound(folded), &strings);
+    }
+    if (snapshot) {
+        return CourseIterator(snapshot.get(), snapshot->lowerBound(folded));
+    }
+    const Node* candidate = nullptr;      // Smallest node seen so far that is not below the key
+    const Node* current = root;
+    PackedKey probe = packKey(folded);
+    while (current != nullptr) {
+        if (compareKeys(current->key, current->course.courseNumber, probe, folded) < 0) {
+            current = current->right;
+        }
+        else {
+            candidate = current;
+            current = current->left;
+        }
+    }
+    return CourseIterator(candidate, root, &strings);
+}
+
+/**
+ * First course whose number is greater than the key (case-insensitive), or end()
+ */
+CourseIterator BinarySearchTree::upper_bound(string_view courseNumber) const {
+    FoldedKey key(courseNumber);
+    CourseIterator position = lower_bound(key.view());
+    if (position != end() && (*position).number() == key.view()) {
+        ++position;                       // Step over the exact match
+    }
+    return position;
+}
+
+/**
+ * Courses numbered from first to last, both inclusive - O(log n) to position,
+ * then O(1) amortized per course visited
+ */
+CourseRange BinarySearchTree::Range(string_view first, string_view last) const {
+    FoldedKey low(first);                 // Bounds are compared the way they are looked up
+    FoldedKey high(last);
+    CourseRange range = { lower_bound(low.view()), upper_bound(high.view()) };
+    if (low.view().compare(high.view()) > 0) {
+        range.last = range.first;         // Reversed bounds select nothing
+    }
+    return range;
+}
+
+/**
+ * Courses whose number starts with prefix (e.g. "MATH2" for every MATH 2xx course)
+ * The range ends at the lower bound of the smallest key that sorts after every
+ * string with the prefix: drop trailing 0xFF bytes, then increment the last byte
+ */
+CourseRange BinarySearchTree::Prefix(string_view prefix) const {
+    FoldedKey key(prefix);
+    string limit(key.view());             // Short prefixes fit in the small-string buffer
+    while (!limit.empty() && static_cast<unsigned char>(limit.back()) == 0xFF) {
+        limit.pop_back();
+    }
+    if (limit.empty()) {
+        return CourseRange{ lower_bound(prefix), end() }; // Nothing sorts after the prefix
+    }
+    limit.back() = static_cast<char>(static_cast<unsigned char>(limit.back()) + 1);
+    return CourseRange{ lower_bound(prefix), lower_bound(limit) };
+}
+
+/**
+ * Count total number of courses in tree
+ * Every node knows the size of its subtree, so this is O(1) in every layout
+ */
+int BinarySearchTree::Size() const {
+    if (frozen) {
+        return static_cast<int>(frozen->size());
+    }
+    if (snapshot) {
+        return static_cast<int>(snapshot->size());
+    }
+    return nodeSize(root);    // The root's subtree is the whole tree
+}
+
+/**
+ * Select: the course at 0-based position k in alphanumeric order (empty if k >= Size())
+ * Descends using subtree sizes - O(log n) on a balanced tree, O(1) on the flat layouts
+ */
+CourseRef BinarySearchTree::Select(size_t k) const {
+    if (frozen) {
+        return k < frozen->size() ? CourseRef(&frozen->at(k), &strings) : CourseRef();
+    }
+    if (snapshot) {
+        return k < snapshot->size() ? CourseRef(snapshot.get(), k) : CourseRef();
+    }
+    Node* current = root;
+    while (current != nullptr) {
+        size_t leftSize = static_cast<size_t>(nodeSize(current->left));
+        if (k < leftSize) {
+            current = current->left;      // Position is inside the left subtree
+        }
+        else if (k == leftSize) {
+            return CourseRef(&current->course, &strings);
+        }
+        else {
+            k -= leftSize + 1;            // Skip the left subtree and this node
+            current = current->right;
+        }
+    }
+    return CourseRef();
+}
+
+/**
+ * Rank: 0-based position of a course in alphanumeric order, or -1 if it does not exist
+ */
+long BinarySearchTree::Rank(string_view courseNumber) const {
+    FoldedKey key(courseNumber);
+    string_view folded = key.view();
+    if (frozen) {
+        return frozen->find(folded);
+    }
+    if (snapshot) {
+        return snapshot->find(folded);
+    }
+    long position = 0;                    // Courses known to come before the key
+    Node* current = root;
+    PackedKey probe = packKey(folded);
+    while (current != nullptr) {
+        int order = compareKeys(probe, folded, current->key, current->course.courseNumber);
+        if (order < 0) {
+            current = current->left;
+        }
+        else {
+            long here = position + nodeSize(current->left);
+            if (order == 0) {
+                return here;
+            }
+            position = here + 1;          // Everything left of and including this node
+            current = current->right;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Maximum depth of the tree (number of nodes on the longest root-to-leaf path)
+ * Heights are maintained on every insert, so this is O(1)
+ * For a snapshot this is the number of binary search probes: floor(log2(n)) + 1
+ */
+int BinarySearchTree::MaxDepth() const {
+    if (frozen) {
+        return frozen->depth();
+    }
+    if (snapshot) {
+        int depth = 0;
+        for (size_t remaining = snapshot->size(); remaining > 0; remaining /= 2) {
+            depth++;
+        }
+        return depth;
+    }
+    return nodeHeight(root);
+}
+
+/**
+ * Courses at each depth, from the root level down - the shape behind MaxDepth()
+ * Frozen indexes and snapshots are searched as complete trees, so level k holds 2^k courses
+ * (the last level the rest); node trees are walked with an explicit stack.
+ */
+vector<size_t> BinarySearchTree::DepthHistogram() const {
+    vector<size_t> levels;
+    if (frozen || snapshot) {
+        size_t remaining = static_cast<size_t>(Size());
+        for (size_t width = 1; remaining > 0; width *= 2) {
+            levels.push_back(min(width, remaining));
+            remaining -= levels.back();
+        }
+        return levels;
+    }
+    vector<pair<const Node*, size_t>> pending;
+    if (root != nullptr) {
+        pending.emplace_back(root, 0);
+    }
+    while (!pending.empty()) {
+        const Node* node = pending.back().first;
+        size_t depth = pending.back().second;
+        pending.pop_back();
+        if (depth >= levels.size()) {
+            levels.resize(depth + 1, 0);
+        }
+        levels[depth]++;
+        if (node->left != nullptr) {
+            pending.emplace_back(node->left, depth + 1);
+        }
+        if (node->right != nullptr) {
+            pending.emplace_back(node->right, depth + 1);
+        }
+    }
+    return levels;
+}
+
+/**
+ * True if the tree keeps itself balanced on insert
+ */
+bool BinarySearchTree::IsBalanced() const {
+    return balanced;
+}
+
+/**
+ * Replace the tree contents with a mapped snapshot
+ * Reads are then served from the mapping without building any nodes
+ */
+void BinarySearchTree::AttachSnapshot(unique_ptr<CatalogSnapshot> mapped) {
+    destroyTree();
+    strings.clear();
+    deadStringBytes = 0;
+    frozen.reset();
+    dropIndexes();
+    snapshot = move(mapped);
+}
+
+/**
+ * Materialize an attached snapshot or frozen index into nodes (no-op for a node-backed tree)
+ */
+void BinarySearchTree::thaw() {
+    vector<StoredCourse> courses;
+    if (frozen) {
+        courses = frozen->release(); // Strings already live in this tree's pool
+        frozen.reset();
+    }
+    else if (snapshot) {
+        courses.reserve(snapshot->size());
+        for (size_t i = 0; i < snapshot->size(); i++) {
+            courses.push_back(snapshot->store(i, strings));
+        }
+        snapshot.reset();
+        dropIndexes();            // The graph's views pointed into the snapshot
+    }
+    else {
+        return;
+    }
+    destroyTree();
+    root = buildRange(courses, 0, courses.size()); // Already sorted - a straight O(n) build
+}
+
+/**
+ * Freeze the catalog: move every course out of its node into a sorted array and index
+ * the keys in Eytzinger order, then free the nodes. Search, PrintCourseList and Size keep
+ * working unchanged; the next Insert thaws the index back into a balanced tree.
+ * Snapshot-backed trees are already flat, so they are left as they are.
+ *
+ * Once removed and replaced courses account for more than half of the string pool, the
+ * live courses are also copied into a fresh pool (an already frozen tree is re-frozen for
+ * this), so repeated incremental reloads cannot grow the pool without bound.
+ */
+void BinarySearchTree::Freeze() {
+    bool compact = deadStringBytes * 2 > strings.bytesReserved();
+    if ((frozen && !compact) || snapshot || (!frozen && root == nullptr)) {
+        return;
+    }
+    vector<StoredCourse> courses;
+    if (frozen) {
+        courses = frozen->release();
+        frozen.reset();
+    }
+    else {
+        courses.reserve(nodeSize(root));
+        for (const Node* node = firstNode(root); node != nullptr; node = nextNode(node)) {
+            courses.push_back(node->course); // In-order walk copying the compact records out of the nodes
+        }
+        destroyTree();            // Strings stay in the pool - only the nodes go
+    }
+    if (!compact) {
+        frozen.reset(new FrozenIndex(move(courses)));
+        return;
+    }
+    bool hadGraph = graph != nullptr;
+    graph.reset();                // Its course numbers are views into the old pool
+    compactStrings(courses);
+    frozen.reset(new FrozenIndex(move(courses)));
+    if (hadGraph) {
+        BuildGraph();
+    }
+}
+
+/**
+ * Copy courses into a fresh string pool and free the old one with everything dead in it
+ * Prerequisite IDs are re-interned, since IDs are positions in the pool that issued them
+ */
+void BinarySearchTree::compactStrings(vector<StoredCourse>& courses) {
+    StringPool compacted;
+    for (StoredCourse& course : courses) {
+        uint32_t* ids = compacted.allocateIds(course.prerequisiteCount);
+        for (uint32_t i = 0; i < course.prerequisiteCount; i++) {
+            ids[i] = compacted.intern(strings.view(course.prerequisites[i]));
+        }
+        course.courseNumber = compacted.view(compacted.intern(course.courseNumber));
+        course.courseName = compacted.store(course.courseName);
+        course.prerequisites = ids;
+    }
+    strings.swap(compacted);      // The old pool is freed when compacted goes out of scope
+    deadStringBytes = 0;
+}
+
+/**
+ * True if reads are served by the frozen index
+ */
+bool BinarySearchTree::IsFrozen() const {
+    return frozen != nullptr;
+}
+
+/**
+ * Check whether a course exists without copying it out of the tree
+ */
+bool BinarySearchTree::Contains(string_view courseNumber) const {
+    return static_cast<bool>(Find(courseNumber));
+}
+
+/**
+ * Build the prerequisite graph (and, for catalogs that fit, its transitive closure)
+ * Course IDs are ranks, so they stay valid across Freeze(); any write discards the graph
+ */
+void BinarySearchTree::BuildGraph() {
+    graph.reset(new PrerequisiteGraph(begin(), end()));
+}
+
+/**
+ * The prerequisite graph of the current contents, or nullptr if it has not been built
+ */
+const PrerequisiteGraph* BinarySearchTree::Graph() const {
+    return graph.get();
+}
+
+/**
+ * Build the course name index (IDs are ranks, like the graph's, so it survives Freeze())
+ */
+void BinarySearchTree::BuildNameIndex() {
+    names.reset(new NameIndex(begin(), end()));
+}
+
+/**
+ * True if the name index is built (writes that change names discard it)
+ */
+bool BinarySearchTree::HasNameIndex() const {
+    return names != nullptr;
+}
+
+/**
+ * Ranked full-text search over course names (empty if the index has not been built)
+ */
+vector<NameMatch> BinarySearchTree::SearchNames(string_view query, size_t limit) const {
+    return names ? names->search(query, limit) : vector<NameMatch>();
+}
+
+/**
+ * Forget the derived indexes; the next load builds them again
+ */
+void BinarySearchTree::dropIndexes() {
+    graph.reset();
+    names.reset();
+}
+
+/**
+ * Save the tree to a snapshot file, stamped with the size and time of sourceFile
+ */
+bool BinarySearchTree::SaveSnapshot(const string& filename, const string& sourceFile) {
+    vector<const StoredCourse*> sortedCourses;
+    if (frozen) {
+        for (size_t i = 0; i < frozen->size(); i++) {
+            sortedCourses.push_back(&frozen->at(i));
+        }
+        return CatalogSnapshot::Write(filename, sortedCourses, strings, sourceFile);
+    }
+    thaw();
+    sortedCourses.reserve(nodeSize(root));
+    for (const Node* node = firstNode(root); node != nullptr; node = nextNode(node)) {
+        sortedCourses.push_back(&node->course); // In-order walk collecting course pointers
+    }
+    return CatalogSnapshot::Write(filename, sortedCourses, strings, sourceFile);
+}
+
+//=====================//
+// Catalog Publication //
+//=====================//
+
+CatalogHandle::~CatalogHandle() {
+    Synchronize();                               // Readers must be gone before the handle is
+    delete current.load();
+}
+
+/**
+ * Swap in a new tree and retire the previous one
+ * The exchange comes before the epoch advance, so a reader that enters in the new
+ * epoch is guaranteed to load the new tree
+ */
+void CatalogHandle::Publish(BinarySearchTree* tree) {
+    BinarySearchTree* previous = current.exchange(tree);
+    uint64_t retiredAt = epoch.fetch_add(1);
+    if (previous != nullptr) {
+        lock_guard<mutex> guard(retireLock);
+        retired.push_back(Retired{ previous, retiredAt });
+    }
+    Reclaim();                                   // Usually frees the tree before last right away
+}
+
+/**
+ * Delete every retired tree that no read section can still be using
+ */
+size_t CatalogHandle::Reclaim() {
+    lock_guard<mutex> guard(retireLock);
+    return reclaimRetired();
+}
+
+size_t CatalogHandle::reclaimRetired() {
+    uint64_t oldest = UINT64_MAX;                // Oldest epoch any reader is inside
+    for (const ReaderSlot& slot : slots) {
+        uint64_t entered = slot.epoch.load();
+        if (entered != 0) {
+            oldest = min(oldest, entered);
+        }
+    }
+    size_t freed = 0;
+    for (size_t i = 0; i < retired.size();) {
+        if (retired[i].epoch < oldest) {
+            delete retired[i].tree;
+            retired[i] = retired.back();
+            retired.pop_back();
+            freed++;
+        }
+        else {
+            i++;
+        }
+    }
+    return freed;
+}
+
+/**
+ * Wait for every reader still in an older epoch to leave, deleting retired trees as they
+ * become free (a grace period, in RCU terms). Must not be called inside a read section.
+ */
+void CatalogHandle::Synchronize() {
+    while (true) {
+        {
+            lock_guard<mutex> guard(retireLock);
+            reclaimRetired();
+            if (retired.empty()) {
+                return;
+            }
+        }
+        this_thread::yield();
+    }
+}
+
+/**
+ * The latest published tree without entering a read section
+ * Safe only on the thread that publishes, since nothing else retires trees
+ */
+const BinarySearchTree* CatalogHandle::Current() const {
+    return current.load();
+}
+
+/**
+ * The latest tree for changing in place - only for programs with no reader threads at all
+ * (the interactive console). Readers are not locked out: one registering after the check
+ * would see a half-updated tree, so the nullptr returned while a CatalogReader exists only
+ * catches misuse. Anything that serves readers must build a new tree and Publish() it.
+ */
+BinarySearchTree* CatalogHandle::EditUnshared() {
+    for (const ReaderSlot& slot : slots) {
+        if (slot.claimed.load()) {
+            return nullptr;
+        }
+    }
+    return current.load();
+}
+
+/**
+ * Claim a free reader slot (waits if all MAX_READERS slots are taken, so a program must
+ * never need more than MAX_READERS readers at once)
+ */
+CatalogReader::CatalogReader(CatalogHandle& catalog) : handle(catalog), slot(nullptr) {
+    while (slot == nullptr) {
+        for (CatalogHandle::ReaderSlot& candidate : handle.slots) {
+            bool expected = false;
+            if (candidate.claimed.compare_exchange_strong(expected, true)) {
+                slot = &candidate;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            this_thread::yield();
+        }
+    }
+}
+
+CatalogReader::~CatalogReader() {
+    slot->epoch.store(0);
+    slot->claimed.store(false);
+}
+
+/**
+ * Announce the epoch first, then load the tree - the order Publish() relies on
+ */
+const BinarySearchTree* CatalogReader::Enter() {
+    slot->epoch.store(handle.epoch.load());
+    return handle.current.load();
+}
+
+void CatalogReader::Exit() {
+    slot->epoch.store(0, memory_order_release);
+}
+
+//=============================//
+// Persistent Catalog Versions //
+//=============================//
+
+/**
+ * Take another reference to a node (nullptr passes through)
+ */
+const VersionNode* CatalogVersion::retain(const VersionNode* node) {
+    if (node != nullptr) {
+        node->references.fetch_add(1, memory_order_relaxed);
+    }
+    return node;
+}
+
+/**
+ * Drop a reference; the last one frees the node and drops its children in turn
+ * Recursion is bounded by the tree height; right children are followed in the loop
+ */
+void CatalogVersion::release(const VersionNode* node) {
+    while (node != nullptr && node->references.fetch_sub(1, memory_order_acq_rel) == 1) {
+        release(node->left);
+        const VersionNode* right = node->right;
+        delete node;
+        node = right;
+    }
+}
+
+CatalogVersion& CatalogVersion::operator=(const CatalogVersion& other) {
+    const VersionNode* previous = root;
+    root = retain(other.root);    // Retain first - other may be this version
+    release(previous);
+    return *this;
+}
+
+/**
+ * New node over two subtrees whose references it takes over
+ */
+const VersionNode* CatalogVersion::makeNode(const shared_ptr<const Course>& course, const PackedKey& key,
+    const VersionNode* left, const VersionNode* right) {
+    return new VersionNode{ key, course, left, right,
+        1 + max(height(left), height(right)), 1 + size(left) + size(right), { 1 } };
+}
+
+/**
+ * makeNode(), rotating new nodes into place when the subtrees' heights differ by two
+ * (the most one insert or remove below can cause). The rotated-away node's reference is
+ * dropped; everything below it stays shared.
+ */
+const VersionNode* CatalogVersion::balance(const shared_ptr<const Course>& course, const PackedKey& key,
+    const VersionNode* left, const VersionNode* right) {
+    if (height(left) > height(right) + 1) {
+        const VersionNode* result;
+        if (height(left->left) >= height(left->right)) {
+            // Single right rotation
+            result = makeNode(left->course, left->key, retain(left->left),
+                makeNode(course, key, retain(left->right), right));
+        }
+        else {
+            // Left-right double rotation
+            const VersionNode* pivot = left->right;
+            result = makeNode(pivot->course, pivot->key,
+                makeNode(left->course, left->key, retain(left->left), retain(pivot->left)),
+                makeNode(course, key, retain(pivot->right), right));
+        }
+        release(left);
+        return result;
+    }
+    if (height(right) > height(left) + 1) {
+        const VersionNode* result;
+        if (height(right->right) >= height(right->left)) {
+            // Single left rotation
+            result = makeNode(right->course, right->key,
+                makeNode(course, key, left, retain(right->left)), retain(right->right));
+        }
+        else {
+            // Right-left double rotation
+            const VersionNode* pivot = right->left;
+            result = makeNode(pivot->course, pivot->key,
+                makeNode(course, key, left, retain(pivot->left)),
+                makeNode(right->course, right->key, retain(pivot->right), retain(right->right)));
+        }
+        release(right);
+        return result;
+    }
+    return makeNode(course, key, left, right);
+}
+
+/**
+ * Copy of the subtree with the course added (or its course replaced) - only the path is copied
+ */
+const VersionNode* CatalogVersion::insertNode(const VersionNode* node, const shared_ptr<const Course>& course,
+    const PackedKey& key) {
+    if (node == nullptr) {
+        return makeNode(course, key, nullptr, nullptr);
+    }
+    int order = compareKeys(key, course->courseNumber, node->key, node->course->courseNumber);
+    if (order < 0) {
+        return balance(node->course, node->key, insertNode(node->left, course, key), retain(node->right));
+    }
+    if (order > 0) {
+        return balance(node->course, node->key, retain(node->left), insertNode(node->right, course, key));
+    }
+    return makeNode(course, key, retain(node->left), retain(node->right)); // Same shape, new payload
+}
+
+/**
+ * Copy of a subtree without its first course
+ */
+const VersionNode* CatalogVersion::removeFirst(const VersionNode* node) {
+    if (node->left == nullptr) {
+        return retain(node->right);
+    }
+    return balance(node->course, node->key, removeFirst(node->left), retain(node->right));
+}
+
+/**
+ * Copy of the subtree without the course (which must be present)
+ * A node with two children is replaced by a copy carrying its in-order successor's course
+ */
+const VersionNode* CatalogVersion::removeNode(const VersionNode* node, const PackedKey& key,
+    string_view courseNumber) {
+    int order = compareKeys(key, courseNumber, node->key, node->course->courseNumber);
+    if (order < 0) {
+        return balance(node->course, node->key, removeNode(node->left, key, courseNumber), retain(node->right));
+    }
+    if (order > 0) {
+        return balance(node->course, node->key, retain(node->left), removeNode(node->right, key, courseNumber));
+    }
+    if (node->left == nullptr || node->right == nullptr) {
+        return retain(node->left != nullptr ? node->left : node->right);
+    }
+    const VersionNode* successor = node->right;
+    while (successor->left != nullptr) {
+        successor = successor->left;
+    }
+    return balance(successor->course, successor->key, retain(node->left), removeFirst(node->right));
+}
+
+/**
+ * Balanced subtree from sorted courses[first, last) - middle element becomes the root
+ */
+const VersionNode* CatalogVersion::buildRange(const vector<shared_ptr<const Course>>& courses,
+    size_t first, size_t last) {
+    if (first >= last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2;
+    return makeNode(courses[middle], packKey(courses[middle]->courseNumber),
+        buildRange(courses, first, middle), buildRange(courses, middle + 1, last));
+}
+
+/**
+ * Version holding a copy of every course in a tree (already in course number order)
+ */
+CatalogVersion CatalogVersion::FromTree(const BinarySearchTree& tree) {
+    vector<shared_ptr<const Course>> courses;
+    courses.reserve(tree.Size());
+    for (CourseRef course : tree) {
+        courses.push_back(make_shared<const Course>(course.toCourse()));
+    }
+    return CatalogVersion(buildRange(courses, 0, courses.size()));
+}
+
+/**
+ * Nodes alive across a set of versions - a shared subtree is counted (and walked) once,
+ * so the cost follows the memory actually held rather than versions times catalog size
+ */
+size_t CatalogVersion::DistinctNodes(const vector<CatalogVersion>& versions) {
+    unordered_set<const VersionNode*> seen;
+    vector<const VersionNode*> stack;
+    for (const CatalogVersion& version : versions) {
+        stack.push_back(version.root);
+        while (!stack.empty()) {
+            const VersionNode* node = stack.back();
+            stack.pop_back();
+            if (node != nullptr && seen.insert(node).second) {
+                stack.push_back(node->left);
+                stack.push_back(node->right);
+            }
+        }
+    }
+    return seen.size();
+}
+
+/**
+ * Find a course by course number (the key is case-folded on the stack)
+ */
+const Course* CatalogVersion::Find(string_view courseNumber) const {
+    FoldedKey key(courseNumber);
+    PackedKey probe = packKey(key.view());
+    const VersionNode* current = root;
+    while (current != nullptr) {
+        int order = compareKeys(probe, key.view(), current->key, current->course->courseNumber);
+        if (order == 0) {
+            return current->course.get();
+        }
+        current = order < 0 ? current->left : current->right;
+    }
+    return nullptr;
+}
+
+/**
+ * New version with the course added, or replacing the course with the same number
+ */
+CatalogVersion CatalogVersion::Insert(const Course& course) const {
+    shared_ptr<const Course> stored = make_shared<const Course>(course);
+    return CatalogVersion(insertNode(root, stored, packKey(stored->courseNumber)));
+}
+
+/**
+ * New version without the course (a copy of this one if it is not present)
+ */
+CatalogVersion CatalogVersion::Remove(string_view courseNumber) const {
+    if (Find(courseNumber) == nullptr) {
+        return *this;
+    }
+    FoldedKey key(courseNumber);
+    return CatalogVersion(removeNode(root, packKey(key.view()), key.view()));
+}
+
+/**
+ * Build an ordinary tree with this version's courses (e.g. to publish it as the live catalog)
+ * The caller owns the tree; indexes are left for the caller to build
+ */
+BinarySearchTree* CatalogVersion::Materialize() const {
+    vector<Course> courses;
+    courses.reserve(Size());
+    ForEach([&](const Course& course) { courses.push_back(course); });
+    BinarySearchTree* tree = new BinarySearchTree();
+    tree->BuildBalanced(courses);
+    return tree;
+}
+
+//===================//
+// Utility Functions //
+//===================//
+
+/**
+ * Parse comma-separated values from CSV file lines
+ */
+vector<string> split(const string& str, char delimiter) {
+    vector<string> tokens;          // Hold the resulting tokens
+    string token;                   // Temporary storage for each token
+    istringstream tokenStream(str); // Create string stream from input string
+
+    // Extract tokens separated by delimiter
+    while (getline(tokenStream, token, delimiter)) {
+        // Trim leading whitespace (spaces, tabs, carriage returns, newlines)
+        token.erase(0, token.find_first_not_of(" \t\r\n"));
+        token.erase(token.find_last_not_of(" \t\r\n") + 1); // Trim trailing whitespace
+        tokens.push_back(token);    // Add cleaned token to result vector
+    }
+
+    return tokens;                  // Return vector of all tokens found
+}
+
+/**
+ * Convert string to uppercase for case-insensitive comparisons and searches
+ */
+string toUpper(string str) {
+    // Apply toupper function to each character in the string
+    transform(str.begin(), str.end(), str.begin(), ::toupper);
+    return str;                // Return the uppercase string
+}
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (!empty.empty()) {
+        if (!empty.back()) {
+            out << ',';
+        }
+        empty.back() = false;
+    }
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    out << '{';
+    empty.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    out << '}';
+    empty.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    out << '[';
+    empty.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    out << ']';
+    empty.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(string_view name) {
+    value(name);
+    out << ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(string_view text) {
+    separate();
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            const char* hex = "0123456789abcdef";
+            out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!(number == number) || number > 1e308 || number < -1e308) {
+        return null();           // NaN or infinity has no JSON spelling
+    }
+    separate();
+    ostringstream text;
+    text.precision(6);
+    text << number;
+    out << text.str();
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long number) {
+    separate();
+    out << number;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out << (flag ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out << "null";
+    return *this;
+}
+
+//========================//
+// SIMD Tokenizer Kernels //
+//========================//
+
+static uint64_t delimiterMaskScalar(const char* block) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        if (block[i] == ',' || block[i] == '\n') {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+static bool hasLowerScalar(const char* str, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (str[i] >= 'a' && str[i] <= 'z') {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void upperCopyScalar(const char* str, size_t length, char* out) {
+    for (size_t i = 0; i < length; i++) {
+        char c = str[i];
+        out[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+    }
+}
+
+#ifdef ABCU_X86_64
+/**
+ * Mark bytes in 'a'..'z' - signed compare works because 'a'-1 and 'z'+1 are both positive
+ */
+static inline __m128i lowerMaskSse2(__m128i bytes) {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(bytes, _mm_set1_epi8('z' + 1)));
+}
+
+static uint64_t delimiterMaskSse2(const char* block) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+        mask |= uint64_t(static_cast<uint32_t>(_mm_movemask_epi8(hits))) << i;
+    }
+    return mask;
+}
+
+static bool hasLowerSse2(const char* str, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        if (_mm_movemask_epi8(lowerMaskSse2(bytes)) != 0) {
+            return true;
+        }
+    }
+    return hasLowerScalar(str + i, length - i);
+}
+
+static void upperCopySse2(const char* str, size_t length, char* out) {
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        bytes = _mm_xor_si128(bytes, _mm_and_si128(lowerMaskSse2(bytes), caseBit)); // Clear bit 5 of lowercase letters
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    upperCopyScalar(str + i, length - i, out + i);
+}
+
+ABCU_TARGET_AVX2 static inline __m256i lowerMaskAvx2(__m256i bytes) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('a' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), bytes));
+}
+
+ABCU_TARGET_AVX2 static uint64_t delimiterMaskAvx2(const char* block) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    uint32_t lowMask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(low, comma), _mm256_cmpeq_epi8(low, newline))));
+    uint32_t highMask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(high, comma), _mm256_cmpeq_epi8(high, newline))));
+    return uint64_t(lowMask) | (uint64_t(highMask) << 32);
+}
+
+ABCU_TARGET_AVX2 static bool hasLowerAvx2(const char* str, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        if (_mm256_movemask_epi8(lowerMaskAvx2(bytes)) != 0) {
+            return true;
+        }
+    }
+    return hasLowerSse2(str + i, length - i);
+}
+
+ABCU_TARGET_AVX2 static void upperCopyAvx2(const char* str, size_t length, char* out) {
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        bytes = _mm256_xor_si256(bytes, _mm256_and_si256(lowerMaskAvx2(bytes), caseBit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+    }
+    upperCopySse2(str + i, length - i, out + i);
+}
+
+/**
+ * True if the CPU and OS both support AVX2 (checked once at startup)
+ */
+static bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, 0, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuidex(info, 1, 0);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6; // OSXSAVE + YMM state
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static const SimdKernels SCALAR_KERNELS = { "scalar", delimiterMaskScalar, hasLowerScalar, upperCopyScalar };
+#ifdef ABCU_X86_64
+static const SimdKernels SSE2_KERNELS = { "sse2", delimiterMaskSse2, hasLowerSse2, upperCopySse2 };
+static const SimdKernels AVX2_KERNELS = { "avx2", delimiterMaskAvx2, hasLowerAvx2, upperCopyAvx2 };
+#endif
+
+/**
+ * Every kernel set this CPU can run, slowest first
+ */
+vector<const SimdKernels*> availableKernels() {
+    vector<const SimdKernels*> kernels = { &SCALAR_KERNELS };
+#ifdef ABCU_X86_64
+    kernels.push_back(&SSE2_KERNELS);
+    if (cpuHasAvx2()) {
+        kernels.push_back(&AVX2_KERNELS);
+    }
+#endif
+    return kernels;
+}
+
+/**
+ * Fastest kernel set for this CPU - chosen on first use and then fixed
+ */
+const SimdKernels& bestKernels() {
+    static const SimdKernels* best = availableKernels().back();
+    return *best;
+}
+
+/**
+ * Zero-copy version of split() - fills tokens with trimmed views into str
+ * Follows the same rules as split() (a trailing delimiter does not produce an empty
+ * token) and reuses the caller's vector, so steady-state parsing does no heap allocation
+ */
+void splitView(string_view str, char delimiter, vector<string_view>& tokens) {
+    tokens.clear();
+    size_t start = 0;
+    while (start < str.size()) {
+        size_t end = str.find(delimiter, start);
+        if (end == string_view::npos) {
+            end = str.size();
+        }
+        string_view token = str.substr(start, end - start);
+
+        // Trim leading and trailing whitespace (spaces, tabs, carriage returns, newlines)
+        size_t first = token.find_first_not_of(" \t\r\n");
+        if (first == string_view::npos) {
+            token = string_view();
+        }
+        else {
+            token = token.substr(first, token.find_last_not_of(" \t\r\n") - first + 1);
+        }
+        tokens.push_back(token);
+        start = end + 1;
+    }
+}
+
+/**
+ * Uppercase a view without allocating when it is already uppercase (the common case)
+ * Both the check and the fold run 16-32 bytes at a time with the best SIMD kernels.
+ * Otherwise the folded copy is appended to buffer, which the caller must have reserved
+ * large enough that it never reallocates (earlier views point into it)
+ */
+string_view toUpperView(string_view str, vector<char>& buffer) {
+    const SimdKernels& kernels = bestKernels();
+    if (!kernels.hasLower(str.data(), str.size())) {
+        return str;                // Already uppercase - keep pointing at the source
+    }
+
+    size_t offset = buffer.size();
+    buffer.resize(offset + str.size()); // Within the reserved capacity - no reallocation
+    kernels.upperCopy(str.data(), str.size(), &buffer[offset]);
+    return string_view(buffer.data() + offset, str.size());
+}
+
+//=====================//
+// Load Data Functions //
+//=====================//
+
+/**
+ * Print a first-pass warning (same wording as the original line-by-line loader)
+ */
+void printParseWarning(const ParseWarning& warning) {
+    cout << "Warning: Line " << warning.lineNumber;
+    if (warning.kind == INVALID_FORMAT) {
+        cout << " skipped - Invalid format (missing course number or name)";
+    }
+    else if (warning.kind == EMPTY_COURSE_NUMBER) {
+        cout << " skipped - Course number is empty";
+        // Show the course name if it exists
+        if (!warning.detail.empty()) {
+            cout << " (Course name: " << warning.detail << ")";
+        }
+    }
+    else {
+        cout << " skipped - Course name is empty"
+            << " (Course number: " << warning.detail << ")";
+    }
+    cout << endl;
+}
+
+/**
+ * Report each prerequisite cycle found by the graph analysis, e.g. "A -> B -> A"
+ * (each arrow reads "requires"); courses on a cycle can never be scheduled
+ */
+void printCycleWarnings(const PrerequisiteGraph& graph) {
+    for (const vector<uint32_t>& cycle : graph.prerequisiteCycles()) {
+        cout << "Warning: Prerequisite cycle - ";
+        for (size_t i = 0; i < cycle.size(); i++) {
+            cout << (i > 0 ? " -> " : "") << graph.number(cycle[i]);
+        }
+        cout << endl;
+    }
+}
+
+/**
+ * Parse CSV text into records (FIRST PASS of loadCourses)
+ * Lines and fields are found with the SIMD delimiter scanner and tokenized in place;
+ * the line-level skip rules are the same as the original getline() loader. Warnings
+ * are collected rather than printed so chunks can be parsed on several threads.
+ * Returns the number of lines in text.
+ */
+int parseCourseLines(string_view text, ParsedCatalog& catalog) {
+    // Case-folded keys are at most as long as the text, so this buffer never reallocates
+    catalog.upperKeys.reserve(text.size());
+
+    return forEachCsvLine(text, bestKernels(), [&](int lineNumber, const vector<string_view>& tokens) {
+        // Validate minimum parameters (course number and name)
+        if (tokens.size() < 2) {
+            catalog.warnings.push_back({ lineNumber, INVALID_FORMAT, string_view() });
+            return;                 // Skip this line and continue with next
+        }
+
+        // Validate that course number is not empty
+        if (tokens[0].empty()) {
+            catalog.warnings.push_back({ lineNumber, EMPTY_COURSE_NUMBER, tokens[1] });
+            return;
+        }
+
+        // Validate that course name is not empty
+        if (tokens[1].empty()) {
+            catalog.warnings.push_back({ lineNumber, EMPTY_COURSE_NAME, tokens[0] });
+            return;
+        }
+
+        // Record the course (views only - no strings are built yet)
+        CourseRecord record;
+        record.courseNumber = toUpperView(tokens[0], catalog.upperKeys); // First token is course number
+        record.courseName = tokens[1];                                   // Second token is course name
+        record.firstPrerequisite = catalog.prerequisites.size();
+
+        // Any remaining non-empty tokens are prerequisite course numbers (stored as uppercase)
+        for (size_t i = 2; i < tokens.size(); i++) {
+            if (!tokens[i].empty()) {
+                catalog.prerequisites.push_back(toUpperView(tokens[i], catalog.upperKeys));
+            }
+        }
+        record.prerequisiteCount = catalog.prerequisites.size() - record.firstPrerequisite;
+
+        catalog.records.push_back(record);
+    });
+}
+
+/**
+ * Parse CSV text on all cores (FIRST PASS of loadCourses for large files)
+ * The text is cut into one chunk per hardware thread, each ending at a newline, and
+ * every chunk is parsed into its own ParsedCatalog. The chunks are then merged in file
+ * order: prerequisite offsets are rebased and warning line numbers are shifted by the
+ * number of lines in the preceding chunks, so the result is identical to a serial parse.
+ */
+void parseCourseLinesParallel(string_view text, ParsedCatalog& catalog) {
+    const size_t PARALLEL_THRESHOLD = 4 * 1024 * 1024; // Bytes - smaller files parse faster serially
+
+    size_t threadCount = thread::hardware_concurrency();
+    if (text.size() < PARALLEL_THRESHOLD || threadCount < 2) {
+        parseCourseLines(text, catalog);
+        return;
+    }
+
+    // Cut at the first newline after each even split point
+    vector<string_view> chunks;
+    size_t chunkStart = 0;
+    for (size_t i = 1; i < threadCount && chunkStart < text.size(); i++) {
+        size_t cut = text.find('\n', max(chunkStart, text.size() * i / threadCount));
+        if (cut == string_view::npos) {
+            break;
+        }
+        chunks.push_back(text.substr(chunkStart, cut + 1 - chunkStart));
+        chunkStart = cut + 1;
+    }
+    if (chunkStart < text.size()) {
+        chunks.push_back(text.substr(chunkStart));
+    }
+
+    // Parse every chunk into its own local buffers
+    vector<ParsedCatalog> parts(chunks.size());
+    vector<int> lineCounts(chunks.size(), 0);
+    vector<thread> workers;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        workers.emplace_back([&, i]() {
+            lineCounts[i] = parseCourseLines(chunks[i], parts[i]);
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    // Merge in file order
+    size_t totalRecords = 0;
+    size_t totalPrerequisites = 0;
+    for (const ParsedCatalog& part : parts) {
+        totalRecords += part.records.size();
+        totalPrerequisites += part.prerequisites.size();
+    }
+    catalog.records.reserve(totalRecords);
+    catalog.prerequisites.reserve(totalPrerequisites);
+
+    int lineOffset = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        ParsedCatalog& part = parts[i];
+        size_t prerequisiteOffset = catalog.prerequisites.size();
+        for (CourseRecord record : part.records) {
+            record.firstPrerequisite += prerequisiteOffset;
+            catalog.records.push_back(record);
+        }
+        catalog.prerequisites.insert(catalog.prerequisites.end(),
+            part.prerequisites.begin(), part.prerequisites.end());
+        for (ParseWarning warning : part.warnings) {
+            warning.lineNumber += lineOffset;
+            catalog.warnings.push_back(warning);
+        }
+        catalog.chunkKeys.push_back(move(part.upperKeys)); // Moving a vector keeps its buffer, so views stay valid
+        lineOffset += lineCounts[i];
+    }
+}
+
+/**
+ * Validate prerequisites for every course using a hash index of course numbers
+ * Returns, for each record, the position of its first unknown prerequisite (-1 if all exist)
+ * The index is built once, so validation is O(n*p) instead of scanning all courses per
+ * prerequisite. Large catalogs are split across hardware threads; each thread writes only
+ * its own slice of the result, so no locking is needed and the result order is unchanged.
+ */
+vector<int> validatePrerequisites(const ParsedCatalog& catalog) {
+    const size_t PARALLEL_THRESHOLD = 50000; // Below this, thread start-up costs more than it saves
+    const vector<CourseRecord>& records = catalog.records;
+
+    // Index every course number
+    unordered_set<string_view, CourseNumberHash> courseIndex;
+    courseIndex.reserve(records.size());
+    for (const CourseRecord& record : records) {
+        courseIndex.insert(record.courseNumber);
+    }
+
+    vector<int> invalidPrerequisite(records.size(), -1);
+
+    // Check records[first, last) - the index is only read here, so threads can share it
+    auto validateRange = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            const CourseRecord& record = records[i];
+            for (size_t j = 0; j < record.prerequisiteCount; j++) {
+                string_view prerequisite = catalog.prerequisites[record.firstPrerequisite + j];
+                if (courseIndex.find(prerequisite) == courseIndex.end()) {
+                    invalidPrerequisite[i] = static_cast<int>(j); // Report first bad one only
+                    break;
+                }
+            }
+        }
+    };
+
+    size_t threadCount = thread::hardware_concurrency();
+    if (records.size() < PARALLEL_THRESHOLD || threadCount < 2) {
+        validateRange(0, records.size());
+        return invalidPrerequisite;
+    }
+
+    vector<thread> workers;
+    size_t chunk = (records.size() + threadCount - 1) / threadCount;
+    for (size_t first = 0; first < records.size(); first += chunk) {
+        workers.emplace_back(validateRange, first, min(first + chunk, records.size()));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    return invalidPrerequisite;
+}
+
+/**
+ * Load courses from CSV file into Binary Search Tree
+ * Uses two-pass approach to validate prerequisites before insertion:
+ * 1. First pass: Read and parse all courses
+ * 2. Second pass: Validate prerequisites and insert into tree
+ * The file is memory-mapped and parsed into views; strings are only created for
+ * courses that pass validation, right before they are committed to the tree
+ */
+void loadCourses(string filename, BinarySearchTree* bst) {
+    cout << "Loading data structure..." << endl;
+    ABCU_STATS_LOAD();
+    ABCU_STATS_PHASE(PHASE_READ);
+
+    MappedFile file(filename); // Attempt to open and map the specified file
+
+    // Check if file opened successfully
+    if (!file.isOpen()) {
+        cout << "Error: Could not open file " << filename << endl;
+        return;              // Exit function if file can't be opened
+    }
+
+    // FIRST PASS: Read and parse each line (chunked across cores for large files)
+    ABCU_STATS_PHASE(PHASE_SPLIT);
+    ParsedCatalog catalog;
+    parseCourseLinesParallel(file.view(), catalog);
+    for (const ParseWarning& warning : catalog.warnings) {
+        printParseWarning(warning);
+    }
+
+    // SECOND PASS: Validate prerequisites and insert valid courses into BST
+    ABCU_STATS_PHASE(PHASE_VALIDATE);
+    int validCourseCount = 0; // Counter for successfully loaded courses
+    vector<Course> validCourses; // Courses that passed validation, in file order
+
+    // Validate every prerequisite against a hash index of all course numbers
+    vector<int> invalidPrerequisite = validatePrerequisites(catalog);
+
+    // Report and skip invalid courses in file order (same messages as the original scan)
+    for (size_t i = 0; i < catalog.records.size(); i++) {
+        const CourseRecord& record = catalog.records[i];
+
+        // If a prerequisite doesn't exist, the course is invalid
+        if (invalidPrerequisite[i] >= 0) {
+            cout << "Warning: Course " << record.courseNumber
+                << " skipped - Invalid prerequisite: "
+                << catalog.prerequisites[record.firstPrerequisite + invalidPrerequisite[i]]
+                << endl;
+            continue;
+        }
+
+        // Only valid courses are materialized into owning strings
+        Course course;
+        course.courseNumber.assign(record.courseNumber);
+        course.courseName.assign(record.courseName);
+        course.prerequisites.reserve(record.prerequisiteCount);
+        for (size_t j = 0; j < record.prerequisiteCount; j++) {
+            course.prerequisites.emplace_back(catalog.prerequisites[record.firstPrerequisite + j]);
+        }
+        validCourses.push_back(move(course));
+        validCourseCount++;  // Increment counter for valid courses
+    }
+
+    // Insert valid courses into the BST
+    ABCU_STATS_PHASE(PHASE_INSERT);
+    if (bst->Size() == 0) {
+        // Empty tree: build it perfectly balanced in one O(n) pass instead of n inserts
+        bst->BuildBalanced(validCourses);
+    }
+    else {
+        for (const Course& course : validCourses) {
+            bst->Insert(course); // Add valid course to binary search tree
+        }
+    }
+
+    // Link prerequisites by course ID so full chains can be answered without tree walks,
+    // and report any cycles the analysis finds (Kahn + Tarjan, linear time)
+    ABCU_STATS_PHASE(PHASE_INDEX);
+    bst->BuildGraph();
+    printCycleWarnings(*bst->Graph());
+    bst->BuildNameIndex();        // Words and trigrams of every course name, for name search
+
+    // Report loading results to user
+    cout << validCourseCount << " courses loaded." << endl;
+    cout << "Tree depth: " << bst->MaxDepth() << endl << endl;
+}
+
+/**
+ * Load a catalog snapshot into the tree if it is valid and up to date with sourceFile, or
+ * sourceFile no longer exists (with a warning). Returns false (leaving the tree untouched)
+ * when the CSV has to be loaded instead
+ */
+bool loadSnapshot(const string& snapshotFile, const string& sourceFile, BinarySearchTree* bst) {
+    unique_ptr<CatalogSnapshot> mapped(new CatalogSnapshot(snapshotFile));
+    SnapshotSource source = mapped->checkSource(sourceFile);
+    if (!mapped->isValid() || source == SOURCE_CHANGED || mapped->size() == 0) {
+        return false;
+    }
+    if (source == SOURCE_MISSING) {
+        cout << "Warning: " << sourceFile << " not found - using snapshot " << snapshotFile
+            << " as it was saved" << endl;
+    }
+    cout << "Loading snapshot " << snapshotFile << "..." << endl;
+    ABCU_STATS_LOAD();
+    ABCU_STATS_PHASE(PHASE_READ);
+    bst->AttachSnapshot(move(mapped));
+    ABCU_STATS_PHASE(PHASE_INDEX);
+    bst->BuildGraph();
+    printCycleWarnings(*bst->Graph());
+    bst->BuildNameIndex();
+    cout << bst->Size() << " courses loaded." << endl << endl;
+    return true;
+}
+
+/**
+ * Compare a freshly parsed file with the loaded tree by course number and content hash
+ * Only the courses that changed are validated: new and edited ones, plus unchanged ones
+ * whose prerequisites may have gone - those requiring a course that left the tree (found
+ * through the old graph's dependents) or a course that was never loaded. The result is
+ * what loadCourses would build: a prerequisite is valid if the file has a course with that
+ * number, and when a number repeats the last valid line wins.
+ */
+CatalogChanges diffCatalog(const ParsedCatalog& catalog, const BinarySearchTree& bst) {
+    const size_t NONE = SIZE_MAX;
+    const vector<CourseRecord>& records = catalog.records;
+    CatalogChanges changes;
+
+    // Latest record for every course number, with earlier lines for the same number chained behind it
+    unordered_map<string_view, size_t, CourseNumberHash> latest;
+    latest.reserve(records.size());
+    vector<size_t> previous(records.size(), NONE);
+    for (size_t i = 0; i < records.size(); i++) {
+        auto inserted = latest.emplace(records[i].courseNumber, i);
+        if (!inserted.second) {
+            previous[i] = inserted.first->second;
+            inserted.first->second = i;
+        }
+    }
+
+    auto recordHash = [&](size_t i) {
+        ContentHash hash;
+        hash.add(records[i].courseName);
+        for (size_t j = 0; j < records[i].prerequisiteCount; j++) {
+            hash.add(catalog.prerequisites[records[i].firstPrerequisite + j]);
+        }
+        return hash.value();
+    };
+
+    // Walk the tree in order; course IDs in the graph are these ranks
+    enum : char { ABSENT, UNCHANGED, CHANGED, RECHECK };
+    vector<char> state(records.size(), ABSENT); // Indexed by each number's latest record
+    vector<uint64_t> loadedHash(records.size(), 0);
+    vector<uint32_t> goneIds;
+    const PrerequisiteGraph* graph = bst.Graph();
+    uint32_t rank = 0;
+    for (CourseRef course : bst) {
+        auto found = latest.find(course.number());
+        if (found == latest.end()) {
+            changes.removed.emplace_back(course.number());
+            goneIds.push_back(rank);
+        }
+        else {
+            ContentHash hash;
+            hash.add(course.name());
+            for (size_t j = 0; j < course.prerequisiteCount(); j++) {
+                hash.add(course.prerequisite(j));
+            }
+            size_t i = found->second;
+            loadedHash[i] = hash.value();
+            state[i] = loadedHash[i] != recordHash(i) ? CHANGED
+                // Fewer graph edges than listed prerequisites: one may name a course outside the tree
+                : graph == nullptr || graph->prerequisiteCount(rank) < course.prerequisiteCount() ? RECHECK
+                : UNCHANGED;
+        }
+        rank++;
+    }
+
+    // Unchanged courses that required a removed one must be checked again
+    if (graph != nullptr) {
+        for (uint32_t gone : goneIds) {
+            for (size_t i = 0; i < graph->dependentCount(gone); i++) {
+                auto found = latest.find(graph->number(graph->dependents(gone)[i]));
+                if (found != latest.end() && state[found->second] == UNCHANGED) {
+                    state[found->second] = RECHECK;
+                }
+            }
+        }
+    }
+
+    // Index of the first prerequisite of record i missing from the file (-1 if none)
+    auto invalidPrerequisite = [&](size_t i) {
+        for (size_t j = 0; j < records[i].prerequisiteCount; j++) {
+            if (latest.find(catalog.prerequisites[records[i].firstPrerequisite + j]) == latest.end()) {
+                return static_cast<long>(j);
+            }
+        }
+        return -1L;
+    };
+
+    // Validate only what changed, newest line first, reporting problems like loadCourses
+    for (size_t i = 0; i < records.size(); i++) {
+        if (state[i] == UNCHANGED) {
+            changes.unchanged++;
+            continue;
+        }
+        if (latest[records[i].courseNumber] != i) {
+            continue;                             // Not the latest line for this number
+        }
+        size_t winner = NONE;
+        for (size_t candidate = i; candidate != NONE; candidate = previous[candidate]) {
+            long invalid = invalidPrerequisite(candidate);
+            if (invalid < 0) {
+                winner = candidate;
+                break;
+            }
+            const CourseRecord& record = records[candidate];
+            cout << "Warning: Course " << record.courseNumber
+                << " skipped - Invalid prerequisite: "
+                << catalog.prerequisites[record.firstPrerequisite + invalid] << endl;
+        }
+
+        if (winner == NONE) {
+            if (state[i] != ABSENT) {
+                changes.removed.emplace_back(records[i].courseNumber); // Loaded before - take it out
+            }
+        }
+        else if (state[i] == ABSENT) {
+            changes.added.push_back(winner);
+        }
+        else if (recordHash(winner) == loadedHash[i]) {
+            changes.unchanged++;                  // Re-checked, and the loaded line still wins
+        }
+        else {
+            changes.updated.push_back(winner);
+        }
+    }
+    return changes;
+}
+
+/**
+ * Reload a catalog file into an already loaded tree, applying only the differences
+ * The file still has to be read and hashed, but strings are only stored, prerequisites
+ * only validated and nodes only touched for courses that were added, edited or removed.
+ * Course IDs are ranks, so an added or removed course means rebuilding the graph and name
+ * index; edits keep them unless they change prerequisites (graph) or names (name index).
+ * Returns false, leaving the tree untouched, if the file cannot be read or has no courses.
+ */
+bool reloadCourses(const string& filename, BinarySearchTree* bst) {
+    cout << "Reloading " << filename << "..." << endl;
+    ABCU_STATS_LOAD();
+    ABCU_STATS_PHASE(PHASE_READ);
+
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cout << "Error: Could not open file " << filename << endl;
+        return false;
+    }
+
+    ABCU_STATS_PHASE(PHASE_SPLIT);
+    ParsedCatalog catalog;
+    parseCourseLinesParallel(file.view(), catalog);
+    for (const ParseWarning& warning : catalog.warnings) {
+        printParseWarning(warning);
+    }
+    if (catalog.records.empty()) {
+        return false;             // Most likely the wrong file - keep what is loaded
+    }
+
+    ABCU_STATS_PHASE(PHASE_VALIDATE);
+    CatalogChanges changes = diffCatalog(catalog, *bst);
+    ABCU_STATS_PHASE(PHASE_INSERT);
+    for (const string& courseNumber : changes.removed) {
+        bst->Remove(courseNumber);
+    }
+    for (size_t i : changes.added) {
+        const CourseRecord& record = catalog.records[i];
+        bst->Emplace(record.courseNumber, record.courseName,
+            catalog.prerequisites.data() + record.firstPrerequisite, record.prerequisiteCount);
+    }
+    for (size_t i : changes.updated) {
+        const CourseRecord& record = catalog.records[i];
+        bst->Update(record.courseNumber, record.courseName,
+            catalog.prerequisites.data() + record.firstPrerequisite, record.prerequisiteCount);
+    }
+
+    // Rebuild only the indexes the writes discarded (edits alone keep every rank in place)
+    ABCU_STATS_PHASE(PHASE_INDEX);
+    if (bst->Graph() == nullptr) {
+        bst->BuildGraph();
+        printCycleWarnings(*bst->Graph());
+    }
+    if (!bst->HasNameIndex()) {
+        bst->BuildNameIndex();
+    }
+
+    cout << changes.added.size() << " added, " << changes.updated.size() << " updated, "
+        << changes.removed.size() << " removed, " << changes.unchanged << " unchanged." << endl;
+    cout << bst->Size() << " courses loaded." << endl << endl;
+    return true;
+}
+
+#ifdef ABCU_ENABLE_STATS
+/**
+ * Upper bound (ns) of the bucket holding the given fraction of all recorded searches
+ */
+static uint64_t searchPercentile(double fraction) {
+    uint64_t total = statistics.searches.load(memory_order_relaxed);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < Statistics::LATENCY_BUCKETS; bucket++) {
+        seen += statistics.searchLatency[bucket].load(memory_order_relaxed);
+        if (total > 0 && static_cast<double>(seen) >= fraction * static_cast<double>(total)) {
+            return uint64_t(2) << bucket;
+        }
+    }
+    return 0;
+}
+#endif
+
+/**
+ * Print tree shape metrics and, when compiled in, load phases, allocations and search latency
+ */
+void printStatistics(const BinarySearchTree* bst) {
+    cout << "Tree: " << bst->Size() << " courses, height " << bst->MaxDepth() << endl;
+    vector<size_t> levels = bst->DepthHistogram();
+    if (!levels.empty()) {
+        cout << "Courses per depth:";
+        for (size_t depth = 0; depth < levels.size(); depth++) {
+            cout << " " << depth + 1 << ":" << levels[depth];
+        }
+        cout << endl;
+    }
+    const PrerequisiteGraph* graph = bst->Graph();
+    if (graph != nullptr && graph->hasClosure()) {
+        cout << "Prerequisite closure: " << (graph->closureBytes() + 1023) / 1024 << " KB bitset (checks are bit tests)" << endl;
+    }
+    else if (graph != nullptr) {
+        cout << "Prerequisite closure: off above " << PrerequisiteGraph::CLOSURE_MAX_COURSES
+            << " courses (checks walk the graph)" << endl;
+    }
+
+#ifdef ABCU_ENABLE_STATS
+    cout << "Last load (" << statistics.loads.load() << " loads so far):" << endl;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        cout << "  " << LOAD_PHASE_NAMES[phase] << ": "
+            << statistics.phaseNanoseconds[phase].load() / 1e6 << " ms, "
+            << statistics.phaseAllocations[phase].load() << " allocations ("
+            << statistics.phaseBytes[phase].load() << " bytes)" << endl;
+    }
+    cout << "Allocations since start: " << statistics.allocations.load() << " ("
+        << statistics.allocatedBytes.load() << " bytes)" << endl;
+    uint64_t searches = statistics.searches.load();
+    cout << "Searches: " << searches;
+    if (searches > 0) {
+        cout << ", mean " << statistics.searchNanoseconds.load() / searches << " ns, p50 <= "
+            << searchPercentile(0.50) << " ns, p99 <= " << searchPercentile(0.99) << " ns";
+    }
+    cout << endl;
+#else
+    cout << "Load timers, allocation counters and search latency are compiled out "
+        << "(build with -DABCU_ENABLE_STATS)." << endl;
+#endif
+    cout << endl;
+}
+
+/**
+ * Write the same figures as printStatistics as one JSON object
+ */
+void writeStatisticsJson(const BinarySearchTree* bst, ostream& out) {
+    JsonWriter json(out);
+    json.beginObject();
+#ifdef ABCU_ENABLE_STATS
+    json.key("enabled").value(true);
+#else
+    json.key("enabled").value(false);
+#endif
+    json.key("tree").beginObject();
+    json.key("courses").value(bst->Size());
+    json.key("height").value(bst->MaxDepth());
+    json.key("depth_histogram").beginArray();
+    for (size_t count : bst->DepthHistogram()) {
+        json.value(count);
+    }
+    json.endArray();
+    json.endObject();
+
+    const PrerequisiteGraph* graph = bst->Graph();
+    if (graph != nullptr) {
+        json.key("closure").beginObject();
+        json.key("enabled").value(graph->hasClosure());
+        json.key("bytes").value(graph->closureBytes());
+        json.key("max_courses").value(PrerequisiteGraph::CLOSURE_MAX_COURSES);
+        json.endObject();
+    }
+
+#ifdef ABCU_ENABLE_STATS
+    json.key("load").beginObject();
+    json.key("count").value(static_cast<long long>(statistics.loads.load()));
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        json.key(LOAD_PHASE_NAMES[phase]).beginObject();
+        json.key("seconds").value(statistics.phaseNanoseconds[phase].load() / 1e9);
+        json.key("allocations").value(static_cast<long long>(statistics.phaseAllocations[phase].load()));
+        json.key("bytes").value(static_cast<long long>(statistics.phaseBytes[phase].load()));
+        json.endObject();
+    }
+    json.endObject();
+
+    json.key("allocations").beginObject();
+    json.key("count").value(static_cast<long long>(statistics.allocations.load()));
+    json.key("bytes").value(static_cast<long long>(statistics.allocatedBytes.load()));
+    json.endObject();
+
+    uint64_t searches = statistics.searches.load();
+    json.key("search").beginObject();
+    json.key("count").value(static_cast<long long>(searches));
+    json.key("mean_ns").value(searches > 0 ? static_cast<double>(statistics.searchNanoseconds.load()) / searches : 0.0);
+    json.key("p50_ns").value(static_cast<long long>(searchPercentile(0.50)));
+    json.key("p99_ns").value(static_cast<long long>(searchPercentile(0.99)));
+    json.key("latency_histogram").beginArray();  // Non-empty buckets: [from_ns, to_ns)
+    for (int bucket = 0; bucket < Statistics::LATENCY_BUCKETS; bucket++) {
+        uint64_t count = statistics.searchLatency[bucket].load();
+        if (count > 0) {
+            json.beginObject();
+            json.key("from_ns").value(static_cast<long long>(uint64_t(1) << bucket));
+            json.key("to_ns").value(static_cast<long long>(uint64_t(2) << bucket));
+            json.key("count").value(static_cast<long long>(count));
+            json.endObject();
+        }
+    }
+    json.endArray();
+    json.endObject();
+#endif
+    json.endObject();
+}
\ No newline at end of file
@@ -0,0 +1,1287 @@
+//=========================================================================//
+// Name        : CourseCatalog.h                                           //
+// Author      : GCZ79                                                     //
+// Version     : 1.0                                                       //
+// Date        : 02/21/2026                                                //
+// Description : Course catalog shared by the advising tools               //
+//=========================================================================//
+
+#ifndef ABCU_COURSE_CATALOG_H
+#define ABCU_COURSE_CATALOG_H
+
+#include <algorithm> // transform() - strings to uppercase for case-insensitive search
+#include <atomic>    // atomic - lock-free catalog publication and reader epochs
+#include <cstdint>   // uint64_t - delimiter bitmasks
+#include <cstring>   // memcpy() - padded tail blocks for the SIMD kernels
+#include <iostream>  // cout/cin - console input/output
+#include <iterator>  // bidirectional_iterator_tag - STL-style course iterators
+#include <memory>    // unique_ptr/shared_ptr - snapshot attached to a tree, courses shared by catalog version
+#include <mutex>     // mutex - list of retired trees waiting to be reclaimed
+#include <string>    // string type - course names, numbers, filenames
+#include <string_view> // string_view - non-owning keys for the course number index
+#include <unordered_map> // unordered_map - string interning table
+#include <vector>    // vector<string> - stores prerequisites and temporary course list
+using namespace std; // standard namespace to avoid typing std:: prefix repeatedly
+
+#ifdef _WIN32
+#define NOMINMAX             // Keep windows.h from defining min()/max() macros
+#include <windows.h> // CreateFileMapping/MapViewOfFile - memory-mapped CSV loading
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ABCU_X86_64 1        // SSE2 is always available; AVX2 is detected at runtime
+#include <immintrin.h>       // SSE2/AVX2 intrinsics for the CSV tokenizer
+#ifdef _MSC_VER
+#include <intrin.h>          // __cpuidex(), _BitScanForward64()
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ABCU_TARGET_AVX2 __attribute__((target("avx2"))) // Compile one function for AVX2
+#define ABCU_PREFETCH(address) __builtin_prefetch(address)
+#define ABCU_NOINLINE __attribute__((noinline))
+#else
+#define ABCU_TARGET_AVX2     // MSVC emits AVX2 intrinsics without a per-function target
+#define ABCU_NOINLINE __declspec(noinline)
+#ifdef ABCU_X86_64
+#define ABCU_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define ABCU_PREFETCH(address)
+#endif
+#endif
+
+//=============================//
+// Course Structure Definition //
+//=============================//
+
+struct Course {
+    string courseNumber;          // Unique identifier for the course (e.g., "CS101")
+    string courseName;            // Full descriptive name of the course
+    vector<string> prerequisites; // Course numbers that must be taken before this course
+
+    // Default constructor - creates an empty course object
+    Course() {}
+};
+
+//====================//
+// Packed Course Keys //
+//====================//
+
+/**
+ * Course number packed into two 64-bit words so that comparing keys is two integer compares
+ * The first 16 bytes are loaded big-endian and zero padded, which makes (high, low) order
+ * the same as string order. Longer numbers share their packed prefix and are told apart by
+ * comparing the full strings (see compareKeys).
+ */
+const size_t PACKED_KEY_BYTES = 16;
+
+struct PackedKey {
+    uint64_t high;  // Bytes 0-7, first byte most significant
+    uint64_t low;   // Bytes 8-15
+};
+
+/**
+ * Eight bytes as a big-endian integer (compilers turn this into one load and a byte swap)
+ */
+inline uint64_t loadBigEndian(const unsigned char* bytes) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++) {
+        word = (word << 8) | bytes[i];
+    }
+    return word;
+}
+
+/**
+ * Pack an (already uppercase) course number
+ */
+inline PackedKey packKey(string_view courseNumber) {
+    unsigned char bytes[PACKED_KEY_BYTES] = {};
+    memcpy(bytes, courseNumber.data(), min(courseNumber.size(), PACKED_KEY_BYTES));
+    return PackedKey{ loadBigEndian(bytes), loadBigEndian(bytes + 8) };
+}
+
+/**
+ * Order of two packed keys alone (<0, 0, >0)
+ */
+inline int comparePacked(const PackedKey& a, const PackedKey& b) {
+    if (a.high != b.high) {
+        return a.high < b.high ? -1 : 1;
+    }
+    if (a.low != b.low) {
+        return a.low < b.low ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Exact order of two course numbers given with their packed keys (<0, 0, >0)
+ * Equal packed keys of short numbers differ at most by trailing zero bytes, so their
+ * lengths decide; the strings themselves are only read when a number is longer than 16 bytes
+ */
+inline int compareKeys(const PackedKey& a, string_view aNumber, const PackedKey& b, string_view bNumber) {
+    int order = comparePacked(a, b);
+    if (order != 0) {
+        return order;
+    }
+    if (aNumber.size() <= PACKED_KEY_BYTES && bNumber.size() <= PACKED_KEY_BYTES) {
+        return (aNumber.size() > bNumber.size()) - (aNumber.size() < bNumber.size());
+    }
+    return aNumber.compare(bNumber);
+}
+
+/**
+ * Hash for course-number indexes: mixes the two packed words instead of hashing byte by byte
+ * (numbers longer than 16 bytes hash by their prefix; the index's key compare separates them)
+ */
+struct CourseNumberHash {
+    size_t operator()(string_view courseNumber) const {
+        PackedKey key = packKey(courseNumber);
+        uint64_t mixed = key.high ^ (key.low * 0x9E3779B97F4A7C15ULL) ^ courseNumber.size();
+        mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCDULL;  // MurmurHash3 finalizer
+        mixed = (mixed ^ (mixed >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+        return static_cast<size_t>(mixed ^ (mixed >> 33));
+    }
+};
+
+//======================================//
+// Arena Allocator and String Interning //
+//======================================//
+
+/**
+ * Bump allocator that hands out memory from large blocks and frees it all at once
+ * Tree nodes and catalog strings are allocated here instead of one heap call each,
+ * which keeps them packed together and makes tearing a catalog down a single release.
+ * Only trivially destructible objects may be placed in an arena (nothing is destroyed).
+ */
+class Arena {
+private:
+    vector<char*> blocks;   // Every block allocated so far
+    char* cursor;           // Next free byte in the newest block
+    size_t remaining;       // Free bytes left in the newest block
+    size_t blockSize;       // Size of a regular block
+    size_t reserved;        // Total bytes held in blocks
+
+public:
+    explicit Arena(size_t blockBytes = 64 * 1024)
+        : cursor(nullptr), remaining(0), blockSize(blockBytes), reserved(0) {}
+    ~Arena() { release(); }
+    Arena(const Arena&) = delete;            // Owns its blocks - not copyable
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+    void release();                          // Free every block at once
+    void swap(Arena& other);                 // Exchange blocks (pointers into them stay valid)
+    size_t bytesReserved() const { return reserved; }
+};
+
+/**
+ * Catalog-wide string table
+ * Course numbers are interned: every distinct number is stored once and identified by a
+ * dense 32-bit ID, so the many prerequisite references to a course share its bytes.
+ * Course names are copied into the same arena without interning (they rarely repeat).
+ */
+class StringPool {
+private:
+    Arena arena;                             // Bytes of every stored string and ID array
+    unordered_map<string_view, uint32_t> ids; // Interned string -> ID
+    vector<string_view> strings;             // ID -> interned string
+
+public:
+    uint32_t intern(string_view str);        // ID of str, adding it on first use
+    string_view view(uint32_t id) const { return strings[id]; }
+    string_view store(string_view str);      // Arena copy of str (not interned)
+    uint32_t* allocateIds(size_t count);     // Room for a prerequisite ID list
+    void clear();                            // Forget every string at once
+    void swap(StringPool& other);            // Exchange contents (views and IDs stay valid)
+    size_t size() const { return strings.size(); }
+    size_t bytesReserved() const { return arena.bytesReserved(); }
+};
+
+/**
+ * Compact course record kept inside the tree
+ * Every field points into the owning tree's StringPool, so the record itself is 48 bytes,
+ * trivially copyable, and needs no destructor. Public APIs still hand out Course objects.
+ */
+struct StoredCourse {
+    string_view courseNumber;      // Interned course number
+    string_view courseName;        // Course name stored in the pool
+    const uint32_t* prerequisites; // Interned IDs of the prerequisite course numbers
+    uint32_t prerequisiteCount;    // Number of prerequisites
+};
+
+StoredCourse storeCourse(const Course& course, StringPool& pool);  // Intern a Course into a pool
+StoredCourse storeCourseViews(string_view courseNumber, string_view courseName, // Same, from borrowed views
+    const string_view* prerequisites, size_t prerequisiteCount, StringPool& pool);
+Course toCourse(const StoredCourse& stored, const StringPool& pool); // Owning Course from a stored record
+
+//===================================//
+// Binary Search Tree Node Structure //
+//===================================//
+
+struct Node {
+    PackedKey key;       // course.courseNumber packed for comparisons (no pointer chase into the pool)
+    StoredCourse course; // Course data stored in this node (strings live in the tree's pool)
+    Node* left;    // Pointer to left child node (courses that come before this one)
+    Node* right;   // Pointer to right child node (courses that come after this one)
+    Node* parent;  // Pointer to parent node (nullptr at the root) - lets iterators walk without a stack
+    int height;    // Height of the subtree rooted here (a leaf has height 1)
+    int size;      // Number of nodes in the subtree rooted here (for O(1) Size and rank queries)
+
+    // Default constructor - initializes pointers to nullptr
+    Node() {
+        left = nullptr;
+        right = nullptr;
+        parent = nullptr;
+        height = 1;
+        size = 1;
+    }
+
+    // Initialize with a course - creates a node containing the given course
+    Node(const StoredCourse& aCourse) : Node() {
+        key = packKey(aCourse.courseNumber);
+        course = aCourse;
+    }
+};
+
+//====================//
+// Memory-Mapped File //
+//====================//
+
+/**
+ * Read-only memory mapping of a whole file
+ * The CSV loader tokenizes straight out of the mapping, so the file is never copied
+ * into per-line strings. Empty files open successfully with size 0.
+ */
+class MappedFile {
+private:
+    const char* contents; // Start of the mapped bytes (nullptr if empty or not open)
+    size_t length;        // Number of mapped bytes
+    bool opened;          // True if the file was opened successfully
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+
+public:
+    explicit MappedFile(const string& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;            // Owns the mapping - not copyable
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return contents; }
+    size_t size() const { return length; }
+    string_view view() const { return string_view(contents, length); }
+};
+
+//==================//
+// Catalog Snapshot //
+//==================//
+
+/**
+ * On-disk layout of a catalog snapshot (all integers in native byte order):
+ *   SnapshotHeader | SnapshotCourse[courseCount] | SnapshotString[prerequisiteCount] | string pool
+ * Courses are sorted by course number, so a lookup is a binary search straight over the
+ * mapped file that compares the packed keys stored inline in each entry. Every string
+ * lives in the pool and is referenced by (offset, length).
+ */
+const char SNAPSHOT_MAGIC[8] = { 'A', 'B', 'C', 'U', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_VERSION = 2;      // Bump whenever the layout changes
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];              // SNAPSHOT_MAGIC
+    uint32_t version;           // SNAPSHOT_VERSION
+    uint32_t byteOrder;         // SNAPSHOT_BYTE_ORDER as written by this machine
+    uint64_t courseCount;       // Entries in the sorted course array
+    uint64_t prerequisiteCount; // Entries in the flattened prerequisite array
+    uint64_t poolSize;          // Bytes in the string pool
+    uint64_t sourceSize;        // Size of the CSV the snapshot was built from
+    int64_t sourceModified;     // Last-write time of that CSV (file clock ticks)
+};
+
+struct SnapshotString {
+    uint32_t offset;            // Start within the string pool
+    uint32_t length;            // Number of bytes
+};
+
+struct SnapshotCourse {
+    PackedKey key;              // packKey(number) - compared during searches
+    SnapshotString number;      // Uppercased course number (the sort key)
+    SnapshotString name;        // Course name
+    uint32_t firstPrerequisite; // Index into the prerequisite array
+    uint32_t prerequisiteCount; // Number of prerequisites
+};
+
+/**
+ * How a snapshot relates to the CSV it was built from
+ */
+enum SnapshotSource {
+    SOURCE_CURRENT,             // Same size and last-write time as when it was saved
+    SOURCE_CHANGED,             // Edited since - the CSV has to be loaded instead
+    SOURCE_MISSING              // Gone - the snapshot is the only copy of the catalog
+};
+
+/**
+ * Read-only catalog served directly from a memory-mapped snapshot file
+ * Opening validates the header, bounds and sort order once; after that no lookup allocates.
+ */
+class CatalogSnapshot {
+private:
+    MappedFile file;
+    const SnapshotHeader* header;
+    const SnapshotCourse* courses;
+    const SnapshotString* prerequisiteList;
+    const char* pool;
+    bool valid;
+
+    bool inPool(const SnapshotString& str) const {
+        return uint64_t(str.offset) + str.length <= header->poolSize;
+    }
+
+public:
+    explicit CatalogSnapshot(const string& filename);
+
+    bool isValid() const { return valid; }
+    size_t size() const { return valid ? static_cast<size_t>(header->courseCount) : 0; }
+    SnapshotSource checkSource(const string& sourceFile) const;
+
+    string_view text(const SnapshotString& str) const { return string_view(pool + str.offset, str.length); }
+    string_view number(size_t index) const { return text(courses[index].number); }
+    string_view name(size_t index) const { return text(courses[index].name); }
+    size_t prerequisiteCount(size_t index) const { return courses[index].prerequisiteCount; }
+    string_view prerequisite(size_t index, size_t which) const {
+        return text(prerequisiteList[courses[index].firstPrerequisite + which]);
+    }
+
+    long find(string_view courseNumber) const;   // Index of the course, or -1
+    size_t lowerBound(string_view courseNumber) const; // First index not below the key
+    size_t lowerBoundFrom(string_view courseNumber, size_t first) const; // Same, known to be >= first
+    Course materialize(size_t index) const;      // Owning copy of one course
+    StoredCourse store(size_t index, StringPool& pool) const; // Copy of one course into a pool
+
+    static bool Write(const string& filename, const vector<const StoredCourse*>& sortedCourses,
+        const StringPool& pool, const string& sourceFile);
+};
+
+//=====================//
+// Frozen Search Index //
+//=====================//
+
+/**
+ * Index of the lowest set bit (mask must be non-zero)
+ */
+inline unsigned lowestBit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * Read-only, cache-friendly replacement for the node tree once loading is finished
+ * Keys are stored in Eytzinger (breadth-first) order in one 64-byte aligned array, so the
+ * first levels of every search share a few hot cache lines and the next levels can be
+ * prefetched. Only keys are touched while descending; the Course payloads live in a
+ * separate sorted "cold" array that is read once per hit (and scanned for listing).
+ */
+class FrozenIndex {
+private:
+    vector<StoredCourse> courses; // Cold payload, sorted by course number
+    PackedKey* keys;           // keys[1..count] in Eytzinger order (slot 0 unused)
+    uint32_t* ranks;           // ranks[k] = position of keys[k] in courses
+    size_t count;
+    bool longKeys;             // True if some course number is longer than PACKED_KEY_BYTES
+
+    size_t fill(size_t slot, size_t next);
+    int compareSlot(size_t slot, const PackedKey& probe, string_view key) const;
+    size_t lowerSlot(const PackedKey& probe, string_view key) const;
+
+public:
+    explicit FrozenIndex(vector<StoredCourse>&& sortedCourses);
+    ~FrozenIndex();
+    FrozenIndex(const FrozenIndex&) = delete;
+    FrozenIndex& operator=(const FrozenIndex&) = delete;
+
+    size_t size() const { return count; }
+    const StoredCourse& at(size_t rank) const { return courses[rank]; }
+    void replace(size_t rank, const StoredCourse& course) { courses[rank] = course; } // Same number only
+    long find(string_view courseNumber) const;  // Rank of the course, or -1 (key must be uppercase)
+    size_t lowerBound(string_view courseNumber) const; // Rank of the first course not below the key
+    void findBatch(const string_view* courseNumbers, size_t count, long* ranks) const; // Many finds at once
+    int depth() const;                          // Levels in the implicit tree
+    vector<StoredCourse> release();             // Hand the sorted courses back (index becomes empty)
+};
+
+//=======================//
+// Course Lookup Results //
+//=======================//
+
+/**
+ * Uppercase copy of a lookup key kept on the stack
+ * Keys longer than the inline buffer (far longer than any course number) use the heap.
+ */
+class FoldedKey {
+private:
+    char inlineBytes[128];
+    string overflow;
+    string_view folded;
+
+public:
+    explicit FoldedKey(string_view key) {
+        char* out = inlineBytes;
+        if (key.size() > sizeof(inlineBytes)) {
+            overflow.resize(key.size());
+            out = &overflow[0];
+        }
+        for (size_t i = 0; i < key.size(); i++) {
+            char c = key[i];
+            out[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        }
+        folded = string_view(out, key.size());
+    }
+    FoldedKey(const FoldedKey&) = delete;    // folded may point into this object
+    FoldedKey& operator=(const FoldedKey&) = delete;
+
+    string_view view() const { return folded; }
+};
+
+/**
+ * Optional, non-owning reference to a course inside a BinarySearchTree
+ * Works the same whether the tree is node-backed, frozen or snapshot-backed, and reads
+ * every field in place - nothing is copied. Only valid until the tree is modified or
+ * destroyed. Test it like a pointer: if (CourseRef course = bst->Find("cs300")) { ... }
+ */
+class CourseRef {
+private:
+    const StoredCourse* stored;       // Node or frozen record (nullptr otherwise)
+    const StringPool* pool;           // Pool that stored's prerequisite IDs refer to
+    const CatalogSnapshot* snapshot;  // Snapshot holding the course (nullptr otherwise)
+    size_t index;                     // Entry in snapshot
+
+public:
+    CourseRef() : stored(nullptr), pool(nullptr), snapshot(nullptr), index(0) {}
+    CourseRef(const StoredCourse* course, const StringPool* strings)
+        : stored(course), pool(strings), snapshot(nullptr), index(0) {}
+    CourseRef(const CatalogSnapshot* mapped, size_t entry)
+        : stored(nullptr), pool(nullptr), snapshot(mapped), index(entry) {}
+
+    explicit operator bool() const { return stored != nullptr || snapshot != nullptr; }
+
+    string_view number() const { return stored ? stored->courseNumber : snapshot->number(index); }
+    string_view name() const { return stored ? stored->courseName : snapshot->name(index); }
+    size_t prerequisiteCount() const {
+        return stored ? stored->prerequisiteCount : snapshot->prerequisiteCount(index);
+    }
+    string_view prerequisite(size_t which) const {
+        return stored ? pool->view(stored->prerequisites[which]) : snapshot->prerequisite(index, which);
+    }
+
+    /**
+     * Owning copy, for callers that need the course to outlive the tree
+     */
+    Course toCourse() const {
+        Course course;
+        course.courseNumber.assign(number());
+        course.courseName.assign(name());
+        for (size_t i = 0; i < prerequisiteCount(); i++) {
+            course.prerequisites.emplace_back(prerequisite(i));
+        }
+        return course;
+    }
+};
+
+//==================//
+// Course Iterators //
+//==================//
+
+/**
+ * Leftmost (smallest) node of a subtree
+ */
+inline const Node* firstNode(const Node* node) {
+    while (node != nullptr && node->left != nullptr) {
+        node = node->left;
+    }
+    return node;
+}
+
+/**
+ * Rightmost (largest) node of a subtree
+ */
+inline const Node* lastNode(const Node* node) {
+    while (node != nullptr && node->right != nullptr) {
+        node = node->right;
+    }
+    return node;
+}
+
+/**
+ * In-order successor using parent links: the leftmost node of the right subtree, or else
+ * the first ancestor reached from its left side (nullptr after the last node)
+ */
+inline const Node* nextNode(const Node* node) {
+    if (node->right != nullptr) {
+        return firstNode(node->right);
+    }
+    while (node->parent != nullptr && node->parent->right == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+/**
+ * In-order predecessor - the mirror image of nextNode
+ */
+inline const Node* previousNode(const Node* node) {
+    if (node->left != nullptr) {
+        return lastNode(node->left);
+    }
+    while (node->parent != nullptr && node->parent->left == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+/**
+ * Bidirectional iterator over a BinarySearchTree in alphanumeric order
+ * Node-backed trees are walked through parent links, frozen and snapshot-backed trees by
+ * position, so no layout needs a stack. Steps are amortized O(1). Dereferencing yields a
+ * CourseRef by value (there is no operator->), so write (*it).number().
+ * Like CourseRef, only valid until the tree is modified or destroyed.
+ */
+class CourseIterator {
+public:
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = CourseRef;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = CourseRef;
+
+private:
+    const Node* node;                 // Current node, nullptr at end (node-backed trees)
+    const Node* root;                 // Root of the tree, for stepping back from end
+    const FrozenIndex* frozen;        // Frozen index being walked (or nullptr)
+    const CatalogSnapshot* snapshot;  // Snapshot being walked (or nullptr)
+    const StringPool* pool;           // Pool for node and frozen records
+    size_t index;                     // Position in frozen or snapshot, size() at end
+
+public:
+    CourseIterator() : node(nullptr), root(nullptr), frozen(nullptr), snapshot(nullptr),
+        pool(nullptr), index(0) {}
+    CourseIterator(const Node* current, const Node* top, const StringPool* strings)
+        : node(current), root(top), frozen(nullptr), snapshot(nullptr), pool(strings), index(0) {}
+    CourseIterator(const FrozenIndex* index, size_t rank, const StringPool* strings)
+        : node(nullptr), root(nullptr), frozen(index), snapshot(nullptr), pool(strings), index(rank) {}
+    CourseIterator(const CatalogSnapshot* mapped, size_t entry)
+        : node(nullptr), root(nullptr), frozen(nullptr), snapshot(mapped), pool(nullptr), index(entry) {}
+
+    CourseRef operator*() const {
+        if (frozen) return CourseRef(&frozen->at(index), pool);
+        if (snapshot) return CourseRef(snapshot, index);
+        return CourseRef(&node->course, pool);
+    }
+
+    CourseIterator& operator++() {
+        if (frozen || snapshot) index++;
+        else node = nextNode(node);
+        return *this;
+    }
+
+    CourseIterator& operator--() {
+        if (frozen || snapshot) index--;
+        else node = node == nullptr ? lastNode(root) : previousNode(node);
+        return *this;
+    }
+
+    CourseIterator operator++(int) { CourseIterator before = *this; ++*this; return before; }
+    CourseIterator operator--(int) { CourseIterator before = *this; --*this; return before; }
+
+    bool operator==(const CourseIterator& other) const {
+        return node == other.node && index == other.index;
+    }
+    bool operator!=(const CourseIterator& other) const { return !(*this == other); }
+};
+
+/**
+ * A [begin, end) pair of iterators, usable directly in a range-based for loop
+ */
+struct CourseRange {
+    CourseIterator first;   // First course in the range
+    CourseIterator last;    // One past the last course in the range
+
+    CourseIterator begin() const { return first; }
+    CourseIterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
+//====================//
+// Prerequisite Graph //
+//====================//
+
+/**
+ * Prerequisite graph over dense course IDs (a course's ID is its rank in alphanumeric order)
+ * Edges are kept in CSR form both ways: the prerequisites of each course and the courses
+ * that list it as a prerequisite. For catalogs up to CLOSURE_MAX_COURSES the transitive
+ * closure is precomputed as one bitset row per course, built by OR-ing prerequisite rows
+ * in topological order, so "is X required before Y" is a single bit test. Larger catalogs
+ * (n^2 bits would not fit) answer the same queries with a walk over the CSR arrays.
+ * Holds views into the tree it was built from - only valid until the tree is modified.
+ */
+class PrerequisiteGraph {
+private:
+    vector<string_view> numbers;            // numbers[id] = course number (sorted)
+    vector<PackedKey> keys;                 // keys[id] = packKey(numbers[id]), searched by find()
+    vector<uint32_t> prerequisiteOffsets;   // Prerequisites of id: [offsets[id], offsets[id + 1])
+    vector<uint32_t> prerequisiteIds;
+    vector<uint32_t> dependentOffsets;      // Courses listing id as a prerequisite
+    vector<uint32_t> dependentIds;
+    vector<uint32_t> order;                 // Topological order, prerequisites first
+    vector<uint32_t> selfReferences;        // Courses listing themselves as a prerequisite
+    vector<vector<uint32_t>> cycles;        // One concrete cycle per strongly connected component
+    uint64_t* closure;                      // closure[id * rowWords ..] = all transitive prerequisites
+    size_t rowWords;                        // Words per closure row (multiple of 4)
+
+    void buildClosure();
+    void findCycles();
+    const uint64_t* row(uint32_t id) const { return closure + id * rowWords; }
+
+public:
+    static const size_t CLOSURE_MAX_COURSES = 16384; // 32 MB of closure bits at the limit
+
+    PrerequisiteGraph(CourseIterator first, CourseIterator last);
+    ~PrerequisiteGraph();
+    PrerequisiteGraph(const PrerequisiteGraph&) = delete;
+    PrerequisiteGraph& operator=(const PrerequisiteGraph&) = delete;
+
+    size_t size() const { return numbers.size(); }
+    string_view number(uint32_t id) const { return numbers[id]; }
+    long find(string_view courseNumber) const;  // ID of a course, or -1 (key must be uppercase)
+    bool hasClosure() const { return closure != nullptr; }  // False above CLOSURE_MAX_COURSES
+    size_t closureBytes() const { return closure != nullptr ? numbers.size() * rowWords * sizeof(uint64_t) : 0; }
+
+    size_t prerequisiteCount(uint32_t id) const {
+        return prerequisiteOffsets[id + 1] - prerequisiteOffsets[id];
+    }
+    const uint32_t* prerequisites(uint32_t id) const { return prerequisiteIds.data() + prerequisiteOffsets[id]; }
+    size_t dependentCount(uint32_t id) const { return dependentOffsets[id + 1] - dependentOffsets[id]; }
+    const uint32_t* dependents(uint32_t id) const { return dependentIds.data() + dependentOffsets[id]; }
+    const vector<uint32_t>& topologicalOrder() const { return order; }
+    bool hasCycles() const { return !cycles.empty(); }
+    const vector<uint32_t>& selfReferencingCourses() const { return selfReferences; }
+    const vector<vector<uint32_t>>& prerequisiteCycles() const { return cycles; } // A requires B ... requires A
+
+    // With the closure these are a bit test and a row scan. Above CLOSURE_MAX_COURSES courses
+    // there is no closure, and every call walks the CSR arrays instead: O(V + E) time and a
+    // visited bitmap per query. Statistics (option 7) shows which one a loaded catalog uses.
+    bool isRequired(uint32_t course, uint32_t prerequisite) const; // True if required, directly or not
+    vector<uint32_t> allPrerequisites(uint32_t course) const;    // Full chain, in alphanumeric order
+    size_t allPrerequisiteCount(uint32_t course) const;          // Length of the full chain
+
+    /**
+     * Call visit(id) for every course in the full chain, in alphanumeric order
+     * Allocation-free when the closure exists (a scan of one row's set bits)
+     */
+    template <typename Visit>
+    void forEachPrerequisite(uint32_t course, Visit visit) const {
+        if (closure == nullptr) {
+            for (uint32_t id : allPrerequisites(course)) {
+                visit(id);
+            }
+            return;
+        }
+        const uint64_t* bits = row(course);
+        for (size_t word = 0; word < rowWords; word++) {
+            for (uint64_t remaining = bits[word]; remaining != 0; remaining &= remaining - 1) {
+                visit(static_cast<uint32_t>(word * 64 + lowestBit(remaining)));
+            }
+        }
+    }
+};
+
+/**
+ * Semester planning for one student at a time over a PrerequisiteGraph
+ * Tracks, per course, how many prerequisites are still missing. Marking a course completed
+ * only touches the courses that depend on it, so a student's record can be updated
+ * incrementally; a full plan is one O(V+E) layered Kahn pass. Buffers are reused between
+ * students, so batch-planning many students does no per-student allocation once warm.
+ * Courses on (or behind) a prerequisite cycle can never become available and are
+ * reported as unschedulable instead of being waited on forever.
+ */
+class SemesterPlanner {
+private:
+    const PrerequisiteGraph& graph;
+    vector<uint32_t> missing;     // missing[id] = prerequisites of id not yet completed
+    vector<char> completed;       // completed[id] != 0 once the student has taken id
+    vector<uint32_t> remaining;   // Scratch copy of missing used while planning
+    vector<uint32_t> ready;       // Scratch: FIFO of courses whose prerequisites are all planned
+
+public:
+    explicit SemesterPlanner(const PrerequisiteGraph& prerequisiteGraph);
+
+    void reset();                               // Start a new student with nothing completed
+    void complete(uint32_t course);             // Record one completed course (O(dependents))
+    bool isCompleted(uint32_t course) const { return completed[course] != 0; }
+    bool isAvailable(uint32_t course) const { return !completed[course] && missing[course] == 0; }
+    void available(vector<uint32_t>& courses) const; // Courses the student can take now
+
+    // Order every remaining course into semesters of at most maxPerSemester (0 = no limit).
+    // Semester s is courses[semesterStarts[s] .. semesterStarts[s + 1]); returns the number
+    // of courses that cannot be scheduled because of prerequisite cycles.
+    size_t plan(vector<uint32_t>& courses, vector<uint32_t>& semesterStarts, size_t maxPerSemester = 0);
+};
+
+//====================//
+// Course Name Search //
+//====================//
+
+/**
+ * One ranked hit from a course name search
+ */
+struct NameMatch {
+    uint32_t course;   // Course ID (its rank in alphanumeric order)
+    float score;       // Higher is better
+};
+
+/**
+ * Inverted index over the words of every course name
+ * Words are ASCII letter/digit runs folded to uppercase and kept in a sorted dictionary,
+ * so all words with a given prefix are one contiguous ID range. Each word has a posting
+ * list of course IDs, each course a list of its word IDs, and each character trigram a
+ * list of the words containing it (for substring and typo-tolerant matching). Queries
+ * start from the rarest term and only ever touch the postings of matching words - no
+ * course is scanned unless one of its words matched. Holds no views into the tree.
+ * Only the ASCII letters a-z are case-folded, matching the course number keys.
+ */
+class NameIndex {
+private:
+    vector<char> wordText;             // Every distinct word, back to back, sorted
+    vector<uint32_t> wordStarts;       // Word w is wordText[wordStarts[w] .. wordStarts[w + 1])
+    vector<uint32_t> postingOffsets;   // Courses containing word w: [offsets[w], offsets[w + 1])
+    vector<uint32_t> postings;
+    vector<uint32_t> courseWordOffsets; // Words of course c: [offsets[c], offsets[c + 1])
+    vector<uint32_t> courseWords;
+    vector<uint32_t> trigramKeys;      // Sorted packed trigrams
+    vector<uint32_t> trigramOffsets;   // Words containing trigramKeys[t]: [offsets[t], offsets[t + 1])
+    vector<uint32_t> trigramWords;
+
+    using TermMatches = vector<pair<uint32_t, float>>; // (word ID, score), sorted by word ID
+
+    string_view word(uint32_t id) const {
+        return string_view(wordText.data() + wordStarts[id], wordStarts[id + 1] - wordStarts[id]);
+    }
+    size_t wordCount() const { return wordStarts.size() - 1; }
+    const uint32_t* trigramPostings(uint32_t key, size_t& count) const;
+    TermMatches matchTerm(string_view term) const;
+
+public:
+    // Scores per kind of match (summed over the terms of a query)
+    static constexpr float EXACT_SCORE = 3.0f;      // Term is a whole word
+    static constexpr float PREFIX_SCORE = 2.0f;     // Term starts a word ("struct" - STRUCTURES)
+    static constexpr float SUBSTRING_SCORE = 1.0f;  // Term is inside a word ("gram" - PROGRAMMING)
+    static constexpr float TYPO_SCORE = 0.75f;      // Within one or two edits, less per edit
+
+    NameIndex(CourseIterator first, CourseIterator last);
+
+    size_t size() const { return courseWordOffsets.size() - 1; }
+    vector<NameMatch> search(string_view query, size_t limit = 10) const; // Best matches first
+};
+
+//=====================================//
+// Binary Search Tree Class Definition //
+//=====================================//
+
+class BinarySearchTree {
+private:
+    Node* root;                              // Pointer to the root node of the tree
+    bool balanced;                           // True if the tree rebalances itself (AVL) on insert
+    unique_ptr<CatalogSnapshot> snapshot;    // Mapped snapshot serving reads instead of nodes (or nullptr)
+    unique_ptr<FrozenIndex> frozen;          // Compacted read-only index replacing the nodes (or nullptr)
+    Arena nodeArena;                         // Memory for every node of the tree
+    Node* freeNodes;                         // Removed nodes waiting for reuse (linked through left)
+    StringPool strings;                      // Course numbers, names and prerequisite IDs
+    size_t deadStringBytes;                  // Pool bytes of courses removed or replaced since
+    unique_ptr<PrerequisiteGraph> graph;     // Prerequisite graph of the current contents (or nullptr)
+    unique_ptr<NameIndex> names;             // Course name search index of the current contents (or nullptr)
+
+    void addNode(Node* node, const StoredCourse& course); // Finds correct position and inserts a node
+    void destroyTree();                      // Frees all nodes at once (one arena release)
+    Node* newNode(const StoredCourse& course); // Allocates a node (a removed one if available)
+    void removeNode(string_view courseNumber); // Unlinks a course's node and rebalances the path
+    void compactStrings(vector<StoredCourse>& courses); // Copies courses into a fresh pool
+
+    friend class TreeChecker;                // Invariant checks in tests/CatalogTests.cpp
+
+public:
+    BinarySearchTree(bool balancedMode = true); // Constructor - initializes empty tree
+    virtual ~BinarySearchTree();        // Destructor - cleans up memory
+    void Insert(const Course& course);  // Insert a course into the tree
+    void Emplace(string_view courseNumber, string_view courseName,
+        const string_view* prerequisites = nullptr, size_t prerequisiteCount = 0); // Insert from views
+    bool Remove(string_view courseNumber); // Remove a course; returns false if it does not exist
+    bool Update(string_view courseNumber, string_view courseName,
+        const string_view* prerequisites, size_t prerequisiteCount); // Replace an existing course in place
+    void BuildBalanced(vector<Course>& courses); // Replace contents with a perfectly balanced tree
+    Course Search(string courseNumber); // Finds and returns a course by its number
+    CourseRef Find(string_view courseNumber) const; // Finds a course without copying or allocating
+    vector<CourseRef> FindMany(const string_view* courseNumbers, size_t count) const; // Batch Find, input order
+    CourseRef Select(size_t k) const;   // Returns the k-th course (0-based) in alphanumeric order
+    long Rank(string_view courseNumber) const; // Returns a course's 0-based position, or -1
+    void PrintCourseList() const;             // Displays all courses in alphanumeric order
+    int Size() const;                         // Returns the total number of courses in the tree
+    int MaxDepth() const;                     // Returns the number of levels on the longest path
+    bool IsBalanced() const;                  // Returns true if the tree runs in balanced (AVL) mode
+    void AttachSnapshot(unique_ptr<CatalogSnapshot> mapped); // Serve reads from a mapped snapshot
+    bool SaveSnapshot(const string& filename, const string& sourceFile); // Write contents to a snapshot
+    void Freeze();                      // Compact the nodes into a read-only cache-friendly index
+    bool IsFrozen() const;              // Returns true if reads are served by the frozen index
+    vector<size_t> DepthHistogram() const; // Number of courses at each depth (index 0 = root level)
+    bool Contains(string_view courseNumber) const; // Returns true if the course exists
+
+    // STL-style traversal (names follow the standard library so algorithms and range-for work)
+    CourseIterator begin() const;       // First course in alphanumeric order
+    CourseIterator end() const;         // One past the last course
+    CourseIterator lower_bound(string_view courseNumber) const; // First course not before the key
+    CourseIterator upper_bound(string_view courseNumber) const; // First course after the key
+    CourseRange Range(string_view first, string_view last) const; // Courses from first to last inclusive
+    CourseRange Prefix(string_view prefix) const; // Courses whose number starts with prefix
+
+    void BuildGraph();                  // Build the prerequisite graph and its transitive closure
+    const PrerequisiteGraph* Graph() const; // Graph of the current contents, or nullptr if not built
+    void BuildNameIndex();              // Build the inverted index over course name words
+    bool HasNameIndex() const;          // True if the name index describes the current contents
+    vector<NameMatch> SearchNames(string_view query, size_t limit = 10) const; // Ranked name search
+
+private:
+    void thaw();                        // Turn a snapshot or frozen index back into nodes before a write
+    Node* buildRange(const vector<StoredCourse>& courses, size_t first, size_t last); // Balanced build helper
+    void dropIndexes();                 // Discard the graph and name index of the old contents
+};
+
+//=====================//
+// Catalog Publication //
+//=====================//
+
+/**
+ * Publication point for the live catalog. A reload builds and freezes a new tree off to
+ * the side, then Publish() swaps it in with one atomic exchange, so readers see either
+ * the old tree or the new one, never a half-built one.
+ *
+ * Old trees are reclaimed by epochs. Each reader thread registers a CatalogReader, which
+ * owns one slot. Entering a read section copies the global epoch into the slot and then
+ * loads the tree pointer. Publish() retires the old tree under the epoch it ends. A
+ * retired tree is deleted once no slot holds an epoch at or before that one. Readers
+ * only do two atomic stores and two loads; no locks, and they never wait for a reload.
+ */
+class CatalogHandle {
+public:
+    static constexpr size_t MAX_READERS = 128;   // CatalogReaders that can exist at the same time
+
+private:
+    struct alignas(64) ReaderSlot {              // One cache line each - no false sharing
+        atomic<bool> claimed{ false };
+        atomic<uint64_t> epoch{ 0 };             // Epoch the reader entered in, 0 when outside
+    };
+    struct Retired {
+        BinarySearchTree* tree;
+        uint64_t epoch;                          // Readers from this epoch on may still see it
+    };
+
+    atomic<BinarySearchTree*> current;
+    atomic<uint64_t> epoch;
+    ReaderSlot slots[MAX_READERS];
+    mutex retireLock;                            // Publishers only - readers never take it
+    vector<Retired> retired;
+
+    size_t reclaimRetired();
+
+    friend class CatalogReader;
+
+public:
+    CatalogHandle() : current(nullptr), epoch(1) {}
+    ~CatalogHandle();
+    CatalogHandle(const CatalogHandle&) = delete;
+    CatalogHandle& operator=(const CatalogHandle&) = delete;
+
+    void Publish(BinarySearchTree* tree);        // Takes ownership; tree must not change again
+    size_t Reclaim();                            // Delete retired trees no reader can see; returns count
+    void Synchronize();                          // Wait until every retired tree is deleted
+    const BinarySearchTree* Current() const;     // Latest tree, for the publishing thread only
+    BinarySearchTree* EditUnshared();            // Latest tree for in-place changes (single-threaded programs only)
+};
+
+/**
+ * A reader thread's registration with a CatalogHandle. Enter() and Exit() bracket every
+ * use of the tree; the pointer from Enter() stays valid until the matching Exit().
+ * Not thread-safe itself - one per thread, and read sections do not nest.
+ */
+class CatalogReader {
+private:
+    CatalogHandle& handle;
+    CatalogHandle::ReaderSlot* slot;
+
+public:
+    explicit CatalogReader(CatalogHandle& catalog);
+    ~CatalogReader();
+    CatalogReader(const CatalogReader&) = delete;
+    CatalogReader& operator=(const CatalogReader&) = delete;
+
+    const BinarySearchTree* Enter();             // Begin a read section - the current tree
+    void Exit();                                 // End it - the tree may be reclaimed afterwards
+};
+
+/**
+ * Read section for a scope
+ */
+class CatalogReadGuard {
+private:
+    CatalogReader& reader;
+    const BinarySearchTree* tree;
+
+public:
+    explicit CatalogReadGuard(CatalogReader& catalogReader) : reader(catalogReader), tree(catalogReader.Enter()) {}
+    ~CatalogReadGuard() { reader.Exit(); }
+    CatalogReadGuard(const CatalogReadGuard&) = delete;
+    CatalogReadGuard& operator=(const CatalogReadGuard&) = delete;
+
+    const BinarySearchTree* get() const { return tree; }
+    const BinarySearchTree* operator->() const { return tree; }
+    const BinarySearchTree& operator*() const { return *tree; }
+};
+
+//=============================//
+// Persistent Catalog Versions //
+//=============================//
+
+/**
+ * Immutable node shared between catalog versions
+ * A node is never changed after it is built. An edit copies the nodes on the path down to
+ * the change and points the copies at the untouched subtrees, so two versions share all but
+ * O(log n) nodes. Each node counts the parents and versions holding it and is freed by
+ * whichever of them lets go last, on any thread.
+ */
+struct VersionNode {
+    PackedKey key;                       // packKey(course->courseNumber)
+    shared_ptr<const Course> course;     // Payload - shared by every copy of this node
+    const VersionNode* left;
+    const VersionNode* right;
+    int height;                          // Height of the subtree rooted here (a leaf has height 1)
+    int size;                            // Courses in the subtree rooted here
+    mutable atomic<uint32_t> references; // Parents plus versions pointing here
+};
+
+/**
+ * One version of the catalog as a persistent AVL tree
+ * Copying a version is O(1) (one reference count), so snapshots are free and an advisor can
+ * keep any number of earlier versions for rollback or branch off "what-if" edits. Insert()
+ * and Remove() leave this version untouched and return a new one that copies only the
+ * O(log n) nodes on the edited path. A version is immutable, so any number of threads may
+ * read and edit from the same version at once; a single CatalogVersion object is guarded
+ * like any other value.
+ */
+class CatalogVersion {
+private:
+    const VersionNode* root;             // Reference held by this version (nullptr when empty)
+
+    explicit CatalogVersion(const VersionNode* adopted) : root(adopted) {}
+
+    static int height(const VersionNode* node) { return node == nullptr ? 0 : node->height; }
+    static int size(const VersionNode* node) { return node == nullptr ? 0 : node->size; }
+    static const VersionNode* retain(const VersionNode* node);
+    static void release(const VersionNode* node);
+    static const VersionNode* makeNode(const shared_ptr<const Course>& course, const PackedKey& key,
+        const VersionNode* left, const VersionNode* right);
+    static const VersionNode* balance(const shared_ptr<const Course>& course, const PackedKey& key,
+        const VersionNode* left, const VersionNode* right);
+    static const VersionNode* insertNode(const VersionNode* node, const shared_ptr<const Course>& course,
+        const PackedKey& key);
+    static const VersionNode* removeNode(const VersionNode* node, const PackedKey& key, string_view courseNumber);
+    static const VersionNode* removeFirst(const VersionNode* node);
+    static const VersionNode* buildRange(const vector<shared_ptr<const Course>>& courses, size_t first, size_t last);
+    template <typename Visit> static void visitNode(const VersionNode* node, Visit& visit);
+
+public:
+    CatalogVersion() : root(nullptr) {}
+    CatalogVersion(const CatalogVersion& other) : root(retain(other.root)) {} // O(1) snapshot
+    CatalogVersion& operator=(const CatalogVersion& other);
+    ~CatalogVersion() { release(root); }
+
+    static CatalogVersion FromTree(const BinarySearchTree& tree); // O(n) - every course copied once
+    static size_t DistinctNodes(const vector<CatalogVersion>& versions); // Nodes kept alive by all of them
+
+    size_t Size() const { return static_cast<size_t>(size(root)); }
+    int Height() const { return height(root); }
+    const Course* Find(string_view courseNumber) const; // Case-insensitive; nullptr if not present
+    CatalogVersion Insert(const Course& course) const;  // Add or replace (number must be uppercase)
+    CatalogVersion Remove(string_view courseNumber) const; // Same version back if it is not present
+    BinarySearchTree* Materialize() const;              // Ordinary balanced tree with the same courses
+
+    /**
+     * Call visit(const Course&) for every course in course number order
+     */
+    template <typename Visit> void ForEach(Visit visit) const { visitNode(root, visit); }
+};
+
+/**
+ * In-order walk of a subtree
+ */
+template <typename Visit>
+void CatalogVersion::visitNode(const VersionNode* node, Visit& visit) {
+    while (node != nullptr) {
+        visitNode(node->left, visit);
+        visit(static_cast<const Course&>(*node->course));
+        node = node->right;
+    }
+}
+
+//===================//
+// Utility Functions //
+//===================//
+
+vector<string> split(const string& str, char delimiter); // Parse comma-separated values from a line
+string toUpper(string str);                              // Uppercase copy for case-insensitive searches
+
+/**
+ * Minimal streaming JSON writer for machine-readable reports
+ * Commas are placed automatically; non-finite numbers are written as null
+ */
+class JsonWriter {
+private:
+    ostream& out;
+    vector<bool> empty;          // Per open object/array: nothing written into it yet
+    bool afterKey;               // A key was just written - its value needs no comma
+
+    void separate();
+
+public:
+    explicit JsonWriter(ostream& stream) : out(stream), afterKey(false) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(string_view name);
+    JsonWriter& value(string_view text);
+    JsonWriter& value(const char* text) { return value(string_view(text)); }
+    JsonWriter& value(double number);
+    JsonWriter& value(long long number);
+    JsonWriter& value(size_t number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(int number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+};
+
+//========================//
+// SIMD Tokenizer Kernels //
+//========================//
+
+/**
+ * One implementation of the byte-classification primitives used by the CSV tokenizer
+ * delimiterMask() marks every ',' and '\n' in a 64-byte block (bit i = byte i);
+ * hasLower()/upperCopy() do ASCII case folding of course numbers
+ */
+struct SimdKernels {
+    const char* name;                                        // "scalar", "sse2" or "avx2"
+    uint64_t (*delimiterMask)(const char* block);            // Block must be 64 readable bytes
+    bool (*hasLower)(const char* str, size_t length);        // Any byte in 'a'..'z'?
+    void (*upperCopy)(const char* str, size_t length, char* out); // ASCII uppercase into out
+};
+
+vector<const SimdKernels*> availableKernels(); // Every kernel set this CPU can run, slowest first
+const SimdKernels& bestKernels();              // Fastest kernel set for this CPU
+
+/**
+ * Iterates over the positions of ',' and '\n' in a buffer, 64 bytes per kernel call
+ * The set bits of the current block are consumed one at a time, so finding the next
+ * delimiter is a bit-scan rather than a byte loop. The final partial block is copied
+ * into a zero-padded buffer so kernels never read past the end of the mapping.
+ */
+class DelimiterScanner {
+private:
+    const char* data;
+    size_t size;
+    size_t blockStart;            // Offset of the block that mask describes
+    uint64_t mask;                // Delimiters in the current block not yet returned
+    const SimdKernels& kernels;
+
+    void loadBlock() {
+        if (blockStart + 64 <= size) {
+            mask = kernels.delimiterMask(data + blockStart);
+        }
+        else {
+            char padded[64] = {};   // Zero bytes are never delimiters
+            memcpy(padded, data + blockStart, size - blockStart);
+            mask = kernels.delimiterMask(padded);
+        }
+    }
+
+public:
+    DelimiterScanner(string_view text, const SimdKernels& kernelSet)
+        : data(text.data()), size(text.size()), blockStart(0), mask(0), kernels(kernelSet) {
+        if (size > 0) {
+            loadBlock();
+        }
+    }
+
+    /**
+     * Position of the next delimiter, or size() when there are none left
+     */
+    size_t next() {
+        while (mask == 0) {
+            blockStart += 64;
+            if (blockStart >= size) {
+                blockStart = size;
+                return size;
+            }
+            loadBlock();
+        }
+        size_t position = blockStart + lowestBit(mask);
+        mask &= mask - 1;         // Clear the bit just returned
+        return position;
+    }
+};
+
+/**
+ * Trim leading and trailing whitespace (spaces, tabs, carriage returns, newlines)
+ * Only the bytes at the two ends are inspected, so this stays scalar
+ */
+inline string_view trimView(string_view token) {
+    size_t first = 0;
+    size_t last = token.size();
+    while (first < last && (token[first] == ' ' || token[first] == '\t'
+        || token[first] == '\r' || token[first] == '\n')) {
+        first++;
+    }
+    while (last > first && (token[last - 1] == ' ' || token[last - 1] == '\t'
+        || token[last - 1] == '\r' || token[last - 1] == '\n')) {
+        last--;
+    }
+    return token.substr(first, last - first);
+}
+
+/**
+ * Tokenize every line of CSV text and hand each one to onLine(lineNumber, tokens)
+ * Tokens follow split()'s rules: trimmed, and a trailing ',' adds no empty token.
+ * Empty lines are counted but not reported. The token vector is reused between lines.
+ * Returns the number of lines seen (so chunked callers can renumber lines afterwards)
+ */
+template <typename LineHandler>
+int forEachCsvLine(string_view text, const SimdKernels& kernels, LineHandler onLine) {
+    DelimiterScanner scanner(text, kernels);
+    vector<string_view> tokens;
+    int lineNumber = 0;
+    size_t lineStart = 0;
+    size_t fieldStart = 0;
+
+    while (lineStart < text.size()) {
+        size_t position = scanner.next();
+        if (position < text.size() && text[position] == ',') {
+            tokens.push_back(trimView(text.substr(fieldStart, position - fieldStart)));
+            fieldStart = position + 1;
+            continue;
+        }
+
+        // End of line ('\n' or end of text)
+        lineNumber++;
+        if (fieldStart < position) {
+            tokens.push_back(trimView(text.substr(fieldStart, position - fieldStart)));
+        }
+        if (position > lineStart) {      // Skip empty lines
+            onLine(lineNumber, tokens);
+        }
+        tokens.clear();
+        lineStart = fieldStart = position + 1;
+    }
+    return lineNumber;
+}
+
+void splitView(string_view str, char delimiter, vector<string_view>& tokens); // Zero-copy split() into trimmed views
+string_view toUpperView(string_view str, vector<char>& buffer); // Uppercase view, copying only when needed
+
+//=====================//
+// Load Data Functions //
+//=====================//
+
+/**
+ * One parsed CSV line - views into the mapped file (or the uppercase key buffer)
+ * Nothing is copied into strings until the course is committed to the tree
+ */
+struct CourseRecord {
+    string_view courseNumber;  // Uppercased course number
+    string_view courseName;    // Trimmed course name
+    size_t firstPrerequisite;  // Index of the first prerequisite in ParsedCatalog::prerequisites
+    size_t prerequisiteCount;  // Number of prerequisites belonging to this course
+};
+
+/**
+ * Line-level problem found during the first pass (printed once parsing is finished)
+ */
+enum ParseWarningKind {
+    INVALID_FORMAT,      // Fewer than two fields
+    EMPTY_COURSE_NUMBER, // detail holds the course name (may be empty)
+    EMPTY_COURSE_NAME    // detail holds the course number
+};
+
+struct ParseWarning {
+    int lineNumber;        // 1-based line number in the file
+    ParseWarningKind kind;
+    string_view detail;    // Field shown in the message
+};
+
+/**
+ * Result of the first pass over a CSV file
+ */
+struct ParsedCatalog {
+    vector<CourseRecord> records;      // Courses that passed the per-line checks, in file order
+    vector<string_view> prerequisites; // Uppercased prerequisites of all records, back to back
+    vector<ParseWarning> warnings;     // Skipped lines, in file order
+    vector<char> upperKeys;            // Storage for keys that had to be case-folded
+    vector<vector<char>> chunkKeys;    // Key storage adopted from chunk parsers when merging
+};
+
+void printParseWarning(const ParseWarning& warning);          // Print a first-pass warning
+void printCycleWarnings(const PrerequisiteGraph& graph);      // Report each prerequisite cycle
+int parseCourseLines(string_view text, ParsedCatalog& catalog); // Parse CSV text into records
+void parseCourseLinesParallel(string_view text, ParsedCatalog& catalog); // Same, on all cores for large files
+vector<int> validatePrerequisites(const ParsedCatalog& catalog); // First unknown prerequisite per record
+void loadCourses(string filename, BinarySearchTree* bst);     // Load a CSV file into an empty tree
+bool loadSnapshot(const string& snapshotFile, const string& sourceFile, BinarySearchTree* bst); // Use a saved snapshot
+
+/**
+ * 64-bit FNV-1a hash of a course's content (name and prerequisites in order)
+ * Two versions of a course with the same number are treated as equal when this matches
+ */
+class ContentHash {
+private:
+    uint64_t hash;
+
+public:
+    ContentHash() : hash(14695981039346656037ull) {}
+    void add(string_view text) {
+        for (char c : text) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        hash = (hash ^ 0x1f) * 1099511628211ull; // Field separator - "AB","C" differs from "A","BC"
+    }
+    uint64_t value() const { return hash; }
+};
+
+/**
+ * What an incremental reload has to do to a loaded tree
+ * Record indexes refer to the ParsedCatalog the changes were computed from
+ */
+struct CatalogChanges {
+    vector<size_t> added;              // New courses (validated)
+    vector<size_t> updated;            // Courses whose name or prerequisites changed (validated)
+    vector<string> removed;            // Courses to take out: gone from the file or no longer valid
+    size_t unchanged = 0;              // Courses left exactly as they are
+};
+
+CatalogChanges diffCatalog(const ParsedCatalog& catalog, const BinarySearchTree& bst); // Changes since the last load
+bool reloadCourses(const string& filename, BinarySearchTree* bst); // Apply only the changes in a catalog file
+void printStatistics(const BinarySearchTree* bst);                 // Tree shape, load phases and search latency
+void writeStatisticsJson(const BinarySearchTree* bst, ostream& out); // Same figures as one JSON object
+
+#endif // ABCU_COURSE_CATALOG_H
\ No newline at end of file
@@ -6,399 +6,401 @@
 // Description : ABCU Advising Assistance Program using Binary Search Tree //
 //=========================================================================//
 
-#include <algorithm> // transform() - strings to uppercase for case-insensitive search
-#include <fstream>   // ifstream - reads the CSV file
-#include <iostream>  // cout/cin - console input/output
-#include <sstream>   // stringstream - parses CSV lines in split() function
-#include <string>    // string type - course names, numbers, filenames
-#include <vector>    // vector<string> - stores prerequisites and temporary course list
-using namespace std; // standard namespace to avoid typing std:: prefix repeatedly
-
-//=============================//
-// Course Structure Definition //
-//=============================//
-
-struct Course {
-    string courseNumber;          // Unique identifier for the course (e.g., "CS101")
-    string courseName;            // Full descriptive name of the course
-    vector<string> prerequisites; // Course numbers that must be taken before this course
-
-    // Default constructor - creates an empty course object
-    Course() {}
-};
+#include "CourseCatalog.h"
 
-//===================================//
-// Binary Search Tree Node Structure //
-//===================================//
+#include <fstream>   // ofstream - saves statistics as JSON
+#include <unordered_set> // unordered_set - prerequisites already missing when what-if edits start
 
-struct Node {
-    Course course; // Course data stored in this node
-    Node* left;    // Pointer to left child node (courses that come before this one)
-    Node* right;   // Pointer to right child node (courses that come after this one)
+//=====================//
+// Load Data Functions //
+//=====================//
 
-    // Default constructor - initializes pointers to nullptr
-    Node() {
-        left = nullptr;
-        right = nullptr;
-    }
+/**
+ * Print course information including prerequisites
+ * Reads the course in place through Find(), so printing does no heap allocation
+ */
+void printCourseInfo(const BinarySearchTree* bst, const string& courseNumber) {
+    // Search for the course in the BST
+    CourseRef course = bst->Find(courseNumber);
 
-    // Initialize with a course - creates a node containing the given course
-    Node(Course aCourse) : Node() {
-        course = aCourse;
+    // Check if course was found
+    if (!course) {
+        cout << "Course " << courseNumber << " not found." << endl << endl;
+        return; // Exit function if course doesn't exist 
     }
-};
-
-//=====================================//
-// Binary Search Tree Class Definition //
-//=====================================//
 
-class BinarySearchTree {
-private:
-    Node* root;                              // Pointer to the root node of the tree
-
-    void addNode(Node* node, Course course); // Recursively finds correct position and inserts a node
-    void inOrder(Node* node);                // Recursively traverses tree in sorted order
-    void destroyTree(Node* node);            // Recursively deletes all nodes to free memory
-
-public:
-    BinarySearchTree();                 // Constructor - initializes empty tree
-    virtual ~BinarySearchTree();        // Destructor - cleans up memory
-    void Insert(Course course);         // Insert a course into the tree
-    Course Search(string courseNumber); // Finds and returns a course by its number
-    void PrintCourseList();             // Displays all courses in alphanumeric order
-    int Size();                         // Returns the total number of courses in the tree
+    // Print course information
+    cout << course.number() << ", " << course.name() << endl;
 
-private:
-    int countNodes(Node* node);         // Recursively counts nodes in the tree
-};
+    // Print prerequisites (if any)
+    if (course.prerequisiteCount() > 0) {
+        cout << "Prerequisites: ";
+        // Iterate through prerequisites, adding commas between them
+        for (size_t i = 0; i < course.prerequisiteCount(); i++) {
+            cout << course.prerequisite(i);
+            if (i < course.prerequisiteCount() - 1) { // Don't add comma after last item
+                cout << ", ";
+            }
+        }
+        cout << endl;
+    }
+    else {
+        cout << "Prerequisites: None" << endl; // No prerequisites for this course
+    }
 
-/**
- * Default constructor - Initializes an empty binary search tree with null root pointer
- */
-BinarySearchTree::BinarySearchTree() {
-    root = nullptr;                     // Start with empty tree - no nodes
-}
+    // Print the full chain when it goes beyond the direct prerequisites (read off the closure)
+    const PrerequisiteGraph* graph = bst->Graph();
+    long id = graph ? graph->find(course.number()) : -1;
+    if (id >= 0 && graph->allPrerequisiteCount(static_cast<uint32_t>(id)) > course.prerequisiteCount()) {
+        const char* separator = "All prerequisites: ";
+        graph->forEachPrerequisite(static_cast<uint32_t>(id), [&](uint32_t prerequisite) {
+            cout << separator << graph->number(prerequisite);
+            separator = ", ";
+        });
+        cout << endl;
+    }
 
-/**
- * Destructor - Frees all dynamically allocated memory when tree is destroyed
- */
-BinarySearchTree::~BinarySearchTree() { 
-    destroyTree(root);                  // Start recursive deletion from the root
+    cout << endl; // Add blank line for readability
 }
 
 /**
- * Recursively destroy tree to free memory - Performs post-order traversal to delete all nodes
+ * Answer "must prerequisiteNumber be taken (directly or through a chain) before courseNumber?"
+ * A single bit test in the precomputed closure
  */
-void BinarySearchTree::destroyTree(Node* node) {
-    if (node != nullptr) {        // Base case: if node is null, nothing to delete
-        destroyTree(node->left);  // Recursively delete entire left subtree first
-        destroyTree(node->right); // Then recursively delete entire right subtree
-        delete node;              // Finally delete the current node itself
+void printRequirement(const BinarySearchTree* bst, const string& courseNumber, const string& prerequisiteNumber) {
+    const PrerequisiteGraph* graph = bst->Graph();
+    if (graph == nullptr) {
+        cout << "Prerequisite graph not available." << endl << endl;
+        return;
+    }
+    long course = graph->find(toUpper(courseNumber));
+    long prerequisite = graph->find(toUpper(prerequisiteNumber));
+    if (course < 0 || prerequisite < 0) {
+        cout << "Course " << (course < 0 ? courseNumber : prerequisiteNumber) << " not found." << endl << endl;
+        return;
     }
+    bool required = graph->isRequired(static_cast<uint32_t>(course), static_cast<uint32_t>(prerequisite));
+    cout << graph->number(static_cast<uint32_t>(prerequisite)) << (required ? " is" : " is not")
+        << " required before " << graph->number(static_cast<uint32_t>(course)) << "." << endl << endl;
 }
 
 /**
- * Insert a course into the tree
+ * Print the best course name matches for a partial, multi-word or misspelled title
  */
-void BinarySearchTree::Insert(Course course) {
-	if (root == nullptr) {        // If tree is empty..
-		root = new Node(course);  // Create a new node with the course and set it as the root
+void printNameSearch(const BinarySearchTree* bst, const string& query) {
+    vector<NameMatch> matches = bst->SearchNames(query);
+    if (matches.empty()) {
+        cout << "No course names match \"" << query << "\"." << endl << endl;
+        return;
     }
-    else {                        // If tree already has nodes..
-        addNode(root, course);    // Call recursive helper to find insertion point
+    for (const NameMatch& match : matches) {
+        CourseRef course = bst->Select(match.course);
+        cout << course.number() << ", " << course.name() << endl;
     }
+    cout << endl;
 }
 
 /**
- * Add a course to some node (recursive)
+ * Plan the remaining semesters for a student given their completed courses
+ * (a comma-separated list of course numbers)
  */
-void BinarySearchTree::addNode(Node* node, Course course) {
-    // Compare course numbers to determine insert position
-    if (course.courseNumber < node->course.courseNumber) {
-        // Course number is smaller - should go in left subtree
-        if (node->left == nullptr) {       // If left child doesn't exist..
-            node->left = new Node(course); // Insert new node as left child
+void printSemesterPlan(const BinarySearchTree* bst, const string& completedList) {
+    const PrerequisiteGraph* graph = bst->Graph();
+    if (graph == nullptr) {
+        cout << "Prerequisite graph not available." << endl << endl;
+        return;
+    }
+    SemesterPlanner planner(*graph);
+    vector<string_view> tokens;
+    splitView(completedList, ',', tokens);       // Tokens come back trimmed
+    for (string_view token : tokens) {
+        if (token.empty()) {
+            continue;
         }
-        else {                             // If left child exists..
-            addNode(node->left, course);   // Recursively continue searching in left subtree
+        FoldedKey number(token);
+        long id = graph->find(number.view());
+        if (id < 0) {
+            cout << "Warning: Course " << token << " not found - ignored." << endl;
+            continue;
         }
+        planner.complete(static_cast<uint32_t>(id));
     }
-    else if (course.courseNumber > node->course.courseNumber) {
-        // Course number is larger - should go in right subtree
-        if (node->right == nullptr) {       // If right child doesn't exist..
-            node->right = new Node(course); // Insert new node as right child
-        }
-        else {                              // If right child exists..
-            addNode(node->right, course);   // Recursively continue searching in right subtree
+
+    vector<uint32_t> courses;
+    vector<uint32_t> semesterStarts;
+    size_t unschedulable = planner.plan(courses, semesterStarts);
+    if (courses.empty()) {
+        cout << "No courses left to schedule." << endl;
+    }
+    for (size_t semester = 0; semester + 1 < semesterStarts.size(); semester++) {
+        sort(courses.begin() + semesterStarts[semester], courses.begin() + semesterStarts[semester + 1]);
+        cout << "Semester " << semester + 1 << ": ";
+        for (uint32_t i = semesterStarts[semester]; i < semesterStarts[semester + 1]; i++) {
+            cout << (i > semesterStarts[semester] ? ", " : "") << graph->number(courses[i]);
         }
+        cout << endl;
     }
-    else {
-        // Course already exists - update it with new data
-        node->course = course;              // Replace existing course with new information
+    if (unschedulable > 0) {
+        cout << unschedulable << " course(s) cannot be scheduled because of prerequisite cycles." << endl;
     }
+    cout << endl;
 }
 
 /**
- * Search for a course by course number
+ * Print how an edited catalog version differs from the version it started from
+ * Both versions are walked in order once; a course whose payload the two versions still
+ * share is known to be unchanged without comparing it
  */
-Course BinarySearchTree::Search(string courseNumber) {
-    // Convert search key to uppercase for case-insensitive search
-    transform(courseNumber.begin(), courseNumber.end(),
-        courseNumber.begin(), ::toupper);
-
-    Node* current = root; // Start searching from the root
-
-    // Continue searching while we haven't reached a leaf
-    while (current != nullptr) {
-        // Check if current node contains the course we are looking for
-        if (current->course.courseNumber == courseNumber) {
-            return current->course; // Found it! Return the course
+void printVersionChanges(const CatalogVersion& base, const CatalogVersion& edited) {
+    vector<const Course*> before;
+    vector<const Course*> after;
+    base.ForEach([&](const Course& course) { before.push_back(&course); });
+    edited.ForEach([&](const Course& course) { after.push_back(&course); });
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t changes = 0;
+    while (i < before.size() || j < after.size()) {
+        int order = i == before.size() ? 1 : j == after.size() ? -1
+            : before[i]->courseNumber.compare(after[j]->courseNumber);
+        if (order < 0) {
+            cout << "  - " << before[i++]->courseNumber << endl;
+            changes++;
         }
-
-        // Decide whether to go left or right based on comparison
-        if (courseNumber < current->course.courseNumber) {
-            current = current->left; // Search key is smaller - go left
+        else if (order > 0) {
+            cout << "  + " << after[j]->courseNumber << ", " << after[j]->courseName << endl;
+            j++;
+            changes++;
         }
         else {
-            current = current->right; // Search key is larger - go right
+            if (before[i] != after[j] && (before[i]->courseName != after[j]->courseName
+                || before[i]->prerequisites != after[j]->prerequisites)) {
+                cout << "  ~ " << after[j]->courseNumber << ", " << after[j]->courseName << endl;
+                changes++;
+            }
+            i++;
+            j++;
         }
     }
-
-    // Return empty course if not found
-    Course course; // Create empty course object
-    return course; // Return empty course
-}
-
-/**
- * Print all courses in alphanumeric order
- */
-void BinarySearchTree::PrintCourseList() {
-    cout << "Here is a sample schedule:" << endl << endl;
-    inOrder(root);
-}
-
-/**
- * In-order traversal to print courses in sorted order
- */
-void BinarySearchTree::inOrder(Node* node) {
-    if (node != nullptr) {    // Base case: if node is null, do nothing
-        inOrder(node->left);  // First, recursively process left subtree (smaller values)
-        cout << node->course.courseNumber << ", "
-            << node->course.courseName << endl; // Then, print current node's data
-        inOrder(node->right); // Finally, recursively process right subtree (larger values)
+    if (changes == 0) {
+        cout << "  No changes." << endl;
     }
 }
 
 /**
- * Count total number of courses in tree
+ * What-if edits kept between visits to the menu option
+ * versions[0] holds the live catalog as of the given generation; later entries are edits
  */
-int BinarySearchTree::Size() {
-    return countNodes(root);  // Start recursive counting from root
-}
+struct WhatIfHistory {
+    vector<CatalogVersion> versions;
+    uint64_t generation = 0;     // Catalog generation that versions[0] was copied from
+};
 
 /**
- * Recursively count nodes
+ * Version without the courses that list a prerequisite it does not contain - the rule
+ * validatePrerequisites() applies to a file: one pass, checked against every course number
+ * in the version, including courses this pass drops (so, as in a load, their own dependents
+ * stay). Prerequisites base already lacked were lines the loaded file skipped and are
+ * accepted as the load accepted them. Warns like loadCourses() for each course dropped.
  */
-int BinarySearchTree::countNodes(Node* node) {
-    if (node == nullptr) {    // Base case: empty subtree has 0 nodes
-        return 0;
-    }
-    // Recursive case: count this node plus all nodes in left and right subtrees
-    return 1 + countNodes(node->left) + countNodes(node->right);
-}
+CatalogVersion dropInvalidCourses(const CatalogVersion& version, const CatalogVersion& base) {
+    unordered_set<string> skippedAtLoad;          // Prerequisites base lists but does not have
+    base.ForEach([&](const Course& course) {
+        for (const string& prerequisite : course.prerequisites) {
+            if (base.Find(prerequisite) == nullptr) {
+                skippedAtLoad.insert(prerequisite);
+            }
+        }
+    });
 
-//===================//
-// Utility Functions //
-//===================//
+    vector<pair<string, string>> invalid;         // Course and its first missing prerequisite
+    version.ForEach([&](const Course& course) {
+        for (const string& prerequisite : course.prerequisites) {
+            if (version.Find(prerequisite) == nullptr && skippedAtLoad.count(prerequisite) == 0) {
+                invalid.emplace_back(course.courseNumber, prerequisite);
+                break;
+            }
+        }
+    });
 
-/**
- * Parse comma-separated values from CSV file lines
- */
-vector<string> split(const string& str, char delimiter) {
-    vector<string> tokens;          // Hold the resulting tokens
-    string token;                   // Temporary storage for each token
-    istringstream tokenStream(str); // Create string stream from input string
-
-    // Extract tokens separated by delimiter
-    while (getline(tokenStream, token, delimiter)) {
-        // Trim leading whitespace (spaces, tabs, carriage returns, newlines)
-        token.erase(0, token.find_first_not_of(" \t\r\n"));
-        token.erase(token.find_last_not_of(" \t\r\n") + 1); // Trim trailing whitespace
-        tokens.push_back(token);    // Add cleaned token to result vector
+    CatalogVersion valid = version;
+    for (const pair<string, string>& course : invalid) {
+        cout << "Warning: Course " << course.first << " skipped - Invalid prerequisite: "
+            << course.second << endl;
+        valid = valid.Remove(course.first);
     }
-
-    return tokens;                  // Return vector of all tokens found
-}
-
-/**
- * Convert string to uppercase for case-insensitive comparisons and searches
- */
-string toUpper(string str) {
-    // Apply toupper function to each character in the string
-    transform(str.begin(), str.end(), str.begin(), ::toupper);
-    return str;                // Return the uppercase string
+    return valid;
 }
 
-//=====================//
-// Load Data Functions //
-//=====================//
-
 /**
- * Load courses from CSV file into Binary Search Tree
- * Uses two-pass approach to validate prerequisites before insertion:
- * 1. First pass: Read and parse all courses
- * 2. Second pass: Validate prerequisites and insert into tree
+ * What-if editing of the live catalog
+ * Edits go to a persistent copy: every edit is a new version sharing all untouched nodes
+ * with the one before, so the whole history stays available for rollback at O(log n)
+ * nodes per edit. The history outlives the session; the O(n) copy of the live catalog is
+ * only made again once a load or reload has changed it (catalogGeneration moved on).
+ * The live catalog is only replaced when the result is applied, which publishes it the
+ * same way a load does and makes the applied version the new starting point.
+ * Returns true if the catalog was replaced.
  */
-void loadCourses(string filename, BinarySearchTree* bst) {
-    cout << "Loading data structure..." << endl;
-
-    ifstream file(filename); // Attempt to open the specified file
-
-    // Check if file opened successfully
-    if (!file.is_open()) {
-        cout << "Error: Could not open file " << filename << endl;
-        return;              // Exit function if file can't be opened
-    }
-
-    // Temporary vector to store all courses for prerequisite validation
-    vector<Course> tempCourses;
-    string line;             // Buffer for each line read from file
-    int lineNumber = 0;      // Track line numbers for error reporting
-
-    // FIRST PASS: Read and parse each line
-    while (getline(file, line)) {
-        lineNumber++;        // Increment line counter
-
-        if (line.empty()) {  // Skip empty lines
-            continue;
+bool runWhatIfSession(CatalogHandle& catalog, WhatIfHistory& history, uint64_t& catalogGeneration) {
+    vector<CatalogVersion>& versions = history.versions;
+    if (versions.empty() || history.generation != catalogGeneration) {
+        if (versions.size() > 1) {
+            cout << "The catalog was reloaded - " << versions.size() - 1 << " earlier edit(s) discarded." << endl;
         }
-
-        // Parse the comma-separated values
-        vector<string> tokens = split(line, ',');
-
-        // Validate minimum parameters (course number and name)
-        if (tokens.size() < 2) {
-            cout << "Warning: Line " << lineNumber
-                << " skipped - Invalid format (missing course number or name)"
-                << endl;
-            continue;         // Skip this line and continue with next
+        versions.assign(1, CatalogVersion::FromTree(*catalog.Current()));
+        history.generation = catalogGeneration;
+    }
+    int choice = 0;
+
+    while (true) {
+        CatalogVersion current = versions.back();   // O(1) - shares every node
+        cout << endl << "What-If Edits (version " << versions.size() - 1 << ", "
+            << current.Size() << " courses):" << endl;
+        cout << "  1. Add or replace a course" << endl;
+        cout << "  2. Remove a course" << endl;
+        cout << "  3. Print a course" << endl;
+        cout << "  4. Show changes" << endl;
+        cout << "  5. Roll back to an earlier version" << endl;
+        cout << "  6. Apply to the catalog" << endl;
+        cout << "  7. Return (edits are kept for next time)" << endl;
+        cout << "Select an option: ";
+
+        if (!(cin >> choice)) {
+            if (cin.eof()) {
+                return false;
+            }
+            cin.clear();
+            choice = 0;
         }
+        cin.ignore(1000, '\n');
 
-        // Validate that course number is not empty
-        if (tokens[0].empty()) {
-            cout << "Warning: Line " << lineNumber
-                << " skipped - Course number is empty";
-            // Show the course name if it exists
-            if (!tokens[1].empty()) {
-                cout << " (Course name: " << tokens[1] << ")";
+        string line;
+        if (choice >= 1 && choice <= 3) {
+            cout << "Course number: ";
+            getline(cin, line);
+            line = toUpper(string(trimView(line)));
+            if (line.empty()) {
+                cout << "No course number given." << endl;
+                continue;
             }
-            cout << endl;
-            continue;
         }
 
-        // Validate that course name is not empty
-        if (tokens[1].empty()) {
-            cout << "Warning: Line " << lineNumber
-                << " skipped - Course name is empty"
-                << " (Course number: " << tokens[0] << ")"
-                << endl;
-            continue;
+        if (choice == 1) {
+            Course course;
+            course.courseNumber = line;
+            cout << "Course name: ";
+            getline(cin, line);
+            course.courseName = string(trimView(line)); // Trimmed like a CSV field
+            if (course.courseName.empty()) {
+                cout << "Error: Course name is empty - course not added." << endl;
+                continue;
+            }
+            cout << "Prerequisites (comma-separated, blank for none): ";
+            getline(cin, line);
+            vector<string_view> tokens;
+            splitView(line, ',', tokens);
+            bool valid = true;
+            for (string_view token : tokens) {
+                if (token.empty()) {
+                    continue;
+                }
+                string prerequisite = toUpper(string(token));
+                if (prerequisite != course.courseNumber && current.Find(prerequisite) == nullptr) {
+                    cout << "Error: Unknown prerequisite " << prerequisite << " - course not added." << endl;
+                    valid = false;
+                    break;
+                }
+                course.prerequisites.push_back(prerequisite);
+            }
+            if (valid) {
+                bool replacing = current.Find(course.courseNumber) != nullptr;
+                versions.push_back(current.Insert(course));
+                cout << "Course " << course.courseNumber << (replacing ? " replaced." : " added.") << endl;
+            }
         }
-
-        // Create course object
-        Course tempCourse;
-        tempCourse.courseNumber = toUpper(tokens[0]); // First token is course number
-        tempCourse.courseName = tokens[1];            // Second token is course name
-
-        // Add prerequisites if they exist (starting at index 2)
-        // Any remaining tokens are prerequisite course numbers
-        for (size_t i = 2; i < tokens.size(); i++) {
-            if (!tokens[i].empty()) {                 // Only add non-empty prerequisites
-                tempCourse.prerequisites.push_back(toUpper(tokens[i])); // Store as uppercase
+        else if (choice == 2) {
+            if (current.Find(line) == nullptr) {
+                cout << "Course " << line << " not found." << endl;
+                continue;
+            }
+            size_t dependents = 0;
+            current.ForEach([&](const Course& course) {
+                dependents += count(course.prerequisites.begin(), course.prerequisites.end(), line) > 0;
+            });
+            versions.push_back(current.Remove(line));
+            cout << "Course " << line << " removed." << endl;
+            if (dependents > 0) {
+                cout << "Warning: " << dependents << " course(s) list " << line
+                    << " as a prerequisite and will be dropped when applied." << endl;
             }
         }
-
-        // Add this course to temporary vector for validation in second pass
-        tempCourses.push_back(tempCourse);
-    }
-
-    file.close(); // Close the file after first pass
-
-    // SECOND PASS: Validate prerequisites and insert valid courses into BST
-    int validCourseCount = 0; // Counter for successfully loaded courses
-
-    // Check each course for prerequisite validity
-    for (const Course& course : tempCourses) {
-        bool isValid = true;  // Assume course is valid until proven otherwise
-
-        // Check each prerequisite of the current course
-        for (const string& prerequisite : course.prerequisites) {
-            bool prerequisiteFound = false; // Flag to track if prerequisite exists
-
-            // Search for prerequisite in the list of all courses
-            for (const Course& validCourse : tempCourses) {
-                if (validCourse.courseNumber == prerequisite) {
-                    prerequisiteFound = true; // Prerequisite exists
-                    break;                    // Exit inner loop once found
-                }
+        else if (choice == 3) {
+            const Course* course = current.Find(line);
+            if (course == nullptr) {
+                cout << "Course " << line << " not found." << endl;
+                continue;
             }
-
-            // If prerequisite doesn't exist, mark course as invalid
-            if (!prerequisiteFound) {
-                cout << "Warning: Course " << course.courseNumber
-                    << " skipped - Invalid prerequisite: " << prerequisite
-                    << endl;
-                isValid = false; // Course is invalid due to missing prerequisite
-                break;           // Exit prerequisite checking loop
+            cout << course->courseNumber << ", " << course->courseName << endl;
+            cout << "Prerequisites: ";
+            for (size_t i = 0; i < course->prerequisites.size(); i++) {
+                cout << (i > 0 ? ", " : "") << course->prerequisites[i];
             }
+            cout << (course->prerequisites.empty() ? "None" : "") << endl;
         }
-
-        // Only insert validated course into BST
-        if (isValid) {
-            bst->Insert(course); // Add valid course to binary search tree
-            validCourseCount++;  // Increment counter for valid courses
+        else if (choice == 4) {
+            printVersionChanges(versions.front(), current);
+            size_t copies = 0;
+            for (const CatalogVersion& version : versions) {
+                copies += version.Size();
+            }
+            cout << versions.size() << " version(s) share " << CatalogVersion::DistinctNodes(versions)
+                << " nodes (separate copies would need " << copies << ")." << endl;
         }
-    }
-
-    // Report loading results to user
-    cout << validCourseCount << " courses loaded." << endl << endl;
-}
-
-/**
- * Print course information including prerequisites
- */
-void printCourseInfo(BinarySearchTree* bst, string courseNumber) {
-    // Search for the course in the BST
-    Course course = bst->Search(courseNumber);
-
-    // Check if course was found (Search returns empty course if not found)
-    if (course.courseNumber.empty()) {
-        cout << "Course " << courseNumber << " not found." << endl << endl;
-        return; // Exit function if course doesn't exist 
-    }
-
-    // Print course information
-    cout << course.courseNumber << ", " << course.courseName << endl;
-
-    // Print prerequisites (if any)
-    if (!course.prerequisites.empty()) {
-        cout << "Prerequisites: ";
-        // Iterate through prerequisites, adding commas between them
-        for (size_t i = 0; i < course.prerequisites.size(); i++) {
-            cout << course.prerequisites[i];
-            if (i < course.prerequisites.size() - 1) { // Don't add comma after last item
-                cout << ", ";
+        else if (choice == 5) {
+            cout << "Roll back to version (0-" << versions.size() - 1 << "): ";
+            size_t version;
+            if (!(cin >> version) || version >= versions.size()) {
+                cin.clear();
+                cout << "Invalid version." << endl;
+            }
+            else {
+                versions.resize(version + 1);   // Later versions are released
+                cout << "Rolled back to version " << version << "." << endl;
             }
+            cin.ignore(1000, '\n');
+        }
+        else if (choice == 6) {
+            current = dropInvalidCourses(current, versions.front()); // The rule a load applies
+            if (current.Size() == 0) {
+                cout << "Cannot apply an empty catalog." << endl;
+                continue;
+            }
+            BinarySearchTree* tree = current.Materialize();
+            tree->BuildGraph();
+            printCycleWarnings(*tree->Graph());
+            tree->BuildNameIndex();
+            tree->Freeze();
+            catalog.Publish(tree);          // Same hand-over as a load - readers keep the old tree
+            versions.assign(1, current);    // Already matches the new catalog - no copy needed
+            history.generation = ++catalogGeneration;
+            cout << tree->Size() << " courses published." << endl << endl;
+            return true;
+        }
+        else if (choice == 7) {
+            cout << endl;
+            return false;
+        }
+        else {
+            cout << "Invalid option." << endl;
         }
-        cout << endl;
-    }
-    else {
-        cout << "Prerequisites: None" << endl; // No prerequisites for this course
     }
-
-    cout << endl; // Add blank line for readability
 }
 
+//=====================//
+// Interactive Console //
+//=====================//
+
 /**
  * Display the menu
  */
@@ -406,6 +408,11 @@ void displayMenu() {
     cout << "1. Load Data Structure." << endl; // Option to load course data from file
     cout << "2. Print Course List." << endl;   // Option to display all courses
     cout << "3. Print Course." << endl;        // Option to view specific course details
+    cout << "4. Check Prerequisite." << endl;  // Option to ask whether one course is required before another
+    cout << "5. Plan Semesters." << endl;      // Option to plan remaining courses from completed ones
+    cout << "6. Search Course Names." << endl; // Option to find courses by (part of) their title
+    cout << "7. Show Statistics." << endl;     // Option to see tree shape, load timings and search latency
+    cout << "8. What-If Edits." << endl;       // Option to try catalog changes on a versioned copy
     cout << "9. Exit" << endl;                 // Option to exit program
     cout << "What would you like to do? ";     // Prompt for user input
 }
@@ -415,10 +422,14 @@ void displayMenu() {
 //===============//
 
 int main() {
-    // Define a binary search tree to hold all courses
-    BinarySearchTree* bst = new BinarySearchTree();
+    // Published catalog - a load swaps in a new tree without disturbing readers of the old one
+    CatalogHandle catalog;
+    catalog.Publish(new BinarySearchTree());
 
     string filename;         // Stores the name of the file to load
+    string loadedFile;       // File the live catalog was last loaded from (what a reload re-reads)
+    uint64_t catalogGeneration = 0; // Bumped whenever the live catalog's contents change
+    WhatIfHistory whatIf;    // What-if edits, kept between visits to option 8
     string courseNumber;     // Stores course number for search operations
     int choice = 0;          // Stores user's main menu choice
     int loadChoice = 0;      // Stores user's file loading submenu choice
@@ -441,6 +452,9 @@ int main() {
         // Clear any remaining characters from input buffer
         cin.ignore(1000, '\n');
 
+        // This thread is the only publisher, so the current tree cannot be reclaimed under it
+        const BinarySearchTree* bst = catalog.Current();
+
         // Process user's choice using switch statement
         switch (choice) {
         case 1:
@@ -449,7 +463,8 @@ int main() {
             cout << "Load Options:" << endl;
             cout << "  1. Load \"CS 300 ABCU_Advising_Program_Input.csv\"" << endl;
             cout << "  2. Enter custom file name" << endl;
-            cout << "  3. Cancel" << endl;
+            cout << "  3. Reload changes to the loaded file" << endl;
+            cout << "  4. Cancel" << endl;
             cout << "Select an option: ";
 
             cin >> loadChoice; // Get user's loading preference
@@ -469,16 +484,25 @@ int main() {
                 // Create temporary tree to test load before replacing current data
                 BinarySearchTree* tempBst = new BinarySearchTree();
 
-                // Load default file into temporary tree
+                // Load default file into temporary tree - from its snapshot when that is current
                 filename = "CS 300 ABCU_Advising_Program_Input.csv";
-                cout << "Loading " << filename << "..." << endl;
-                loadCourses(filename, tempBst);
+                if (!loadSnapshot(filename + ".snap", filename, tempBst)) {
+                    cout << "Loading " << filename << "..." << endl;
+                    loadCourses(filename, tempBst);
+
+                    // Save a snapshot so the next start-up can skip parsing and validation
+                    if (tempBst->Size() > 0 && !tempBst->SaveSnapshot(filename + ".snap", filename)) {
+                        cout << "Warning: Could not write snapshot " << filename << ".snap" << endl;
+                    }
+                }
 
                 // Only replace main tree if load was successful (preserves data on failure)
                 if (tempBst->Size() > 0) {
-                    delete bst;              // Delete old tree
-                    bst = tempBst;           // Replace with successfully loaded tree
-                    dataLoaded = true;       // Set flag indicating data is now loaded
+                    tempBst->Freeze();           // Read-only from here on - compact it for fast lookups
+                    catalog.Publish(tempBst);    // Replace the old tree; it is freed once no reader uses it
+                    dataLoaded = true;           // Set flag indicating data is now loaded
+                    loadedFile = filename;       // A failed load leaves the previous file to reload
+                    catalogGeneration++;
                 }
                 else {
                     delete tempBst;          // Clean up failed temporary tree
@@ -497,9 +521,11 @@ int main() {
 
                 // Only replace main tree if load was successful (preserves data on failure)
                 if (tempBst->Size() > 0) {
-                    delete bst;              // Delete old tree
-                    bst = tempBst;           // Replace with successfully loaded tree
-                    dataLoaded = true;       // Set flag indicating data is now loaded
+                    tempBst->Freeze();           // Read-only from here on - compact it for fast lookups
+                    catalog.Publish(tempBst);    // Replace the old tree; it is freed once no reader uses it
+                    dataLoaded = true;           // Set flag indicating data is now loaded
+                    loadedFile = filename;       // A failed load leaves the previous file to reload
+                    catalogGeneration++;
                 }
                 else {
                     delete tempBst;          // Clean up failed temporary tree
@@ -508,6 +534,23 @@ int main() {
                 }
             }
             else if (loadChoice == 3) {
+                // Apply only what changed since the last load - the console has no reader threads
+                BinarySearchTree* liveBst = catalog.EditUnshared();
+                if (!dataLoaded) {
+                    cout << "No data loaded. Please load data first." << endl;
+                }
+                else if (liveBst == nullptr) {
+                    cout << "The catalog is being read elsewhere and cannot be changed in place." << endl;
+                }
+                else if (reloadCourses(loadedFile, liveBst)) {
+                    liveBst->Freeze();           // Writes thawed it - compact it again
+                    catalogGeneration++;
+                }
+                else {
+                    cout << "Reload failed. Previous data preserved." << endl;
+                }
+            }
+            else if (loadChoice == 4) {
                 cout << "Load cancelled." << endl; // User chose to cancel
             }
             else {
@@ -541,20 +584,88 @@ int main() {
             }
             break;
 
+        case 4:
+            // Transitive prerequisite check option
+            if (!dataLoaded || bst->Size() == 0) {
+                cout << "No data loaded. Please load data first." << endl << endl;
+            }
+            else {
+                string prerequisiteNumber;
+                cout << "Which course are you planning to take? ";
+                getline(cin, courseNumber);
+                cout << "Which course might be required before it? ";
+                getline(cin, prerequisiteNumber);
+                printRequirement(bst, courseNumber, prerequisiteNumber);
+            }
+            break;
+
+        case 5:
+            // Semester planning option
+            if (!dataLoaded || bst->Size() == 0) {
+                cout << "No data loaded. Please load data first." << endl << endl;
+            }
+            else {
+                string completedList;
+                cout << "Which courses have you completed (comma-separated, blank for none)? ";
+                getline(cin, completedList);
+                printSemesterPlan(bst, completedList);
+            }
+            break;
+
+        case 6:
+            // Course name search option
+            if (!dataLoaded || bst->Size() == 0) {
+                cout << "No data loaded. Please load data first." << endl << endl;
+            }
+            else {
+                string query;
+                cout << "Search course names for: ";
+                getline(cin, query);
+                printNameSearch(bst, query);
+            }
+            break;
+
+        case 7:
+            // Statistics option (tree shape always; timers and counters when compiled in)
+            {
+                cout << endl;
+                printStatistics(bst);
+                string jsonFile;
+                cout << "Save as JSON (file name, blank to skip): ";
+                getline(cin, jsonFile);
+                if (!jsonFile.empty()) {
+                    ofstream out(jsonFile);
+                    writeStatisticsJson(bst, out);
+                    out << '\n';
+                    cout << (out ? "Saved " : "Error: Could not write ") << jsonFile << endl;
+                }
+                cout << endl;
+            }
+            break;
+
+        case 8:
+            // What-if editing option (works on a persistent copy; the live catalog changes only when applied)
+            if (!dataLoaded || bst->Size() == 0) {
+                cout << "No data loaded. Please load data first." << endl << endl;
+            }
+            else {
+                runWhatIfSession(catalog, whatIf, catalogGeneration);
+            }
+            break;
+
         case 9:
 			// Exit option - will break out of the loop and end the program
             cout << "Thank you for using the course planner!" << endl;
             break;
 
         default:
-            // Invalid option - any number not 1,2,3,9
+            // Invalid option - any number not 1-9
             cout << choice << " is not a valid option." << endl << endl;
             break;
         }
     }
 
-    // Clean up dynamically allocated memory before program exit
-    delete bst; // Destructor will recursively delete all nodes
+    // The catalog's destructor deletes the published tree (and any retired ones)
 
     return 0;   // Program completed successfully
 }
\ No newline at end of file
@@ -0,0 +1,1069 @@
+//=========================================================================//
+// Name        : CatalogTests.cpp                                          //
+// Author      : GCZ79                                                     //
+// Version     : 1.0                                                       //
+// Date        : 02/21/2026                                                //
+// Description : Behaviour and invariant tests for the course catalog      //
+//=========================================================================//
+
+#include "CourseCatalog.h"
+
+#include <cctype>    // tolower() - lower-case lookup keys
+#include <filesystem> // temp_directory_path() - scratch snapshot files
+#include <fstream>   // ofstream - scratch catalog files for load and reload tests
+#include <functional> // function - one test body run against every tree layout
+#include <set>       // set<string> - reference model for random insert/remove sequences
+#include <sstream>   // ostringstream - swallows loader output
+
+//=============//
+// Test Runner //
+//=============//
+
+static int checkCount = 0;   // Checks evaluated so far
+static int failureCount = 0; // Checks that failed so far
+static const char* currentLayout = nullptr; // Tree layout under test, shown with failures
+
+/**
+ * Record one check, printing the expression and location if it failed
+ */
+static void check(bool passed, const char* expression, const char* file, int line) {
+    checkCount++;
+    if (!passed) {
+        failureCount++;
+        cout << "  FAILED " << file << ":" << line << ": " << expression;
+        if (currentLayout != nullptr) {
+            cout << " [" << currentLayout << "]";
+        }
+        cout << endl;
+    }
+}
+
+#define CHECK(condition) check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+struct TestCase {
+    const char* name;  // Printed before the test runs
+    void (*run)();     // Test body - reports through CHECK
+};
+
+/**
+ * Course with the given number, a name derived from it and optional prerequisites
+ */
+static Course makeCourse(const string& number, vector<string> prerequisites = {}) {
+    Course course;
+    course.courseNumber = number;
+    course.courseName = "Course " + number;
+    course.prerequisites = move(prerequisites);
+    return course;
+}
+
+/**
+ * Course number for a test key - zero-padded so numeric and alphanumeric order agree
+ */
+static string courseNumber(int key) {
+    string digits = to_string(key);
+    return "CS" + string(digits.size() < 4 ? 4 - digits.size() : 0, '0') + digits;
+}
+
+/**
+ * Course numbers of a range or tree, in iteration order
+ */
+template <typename Courses>
+static vector<string> numbersOf(const Courses& courses) {
+    vector<string> numbers;
+    for (CourseRef course : courses) {
+        numbers.emplace_back(course.number());
+    }
+    return numbers;
+}
+
+/**
+ * Run a test against the same courses held as nodes, as a frozen index and as a mapped
+ * snapshot - every read query has to give the same answers on all three
+ */
+static void forEachLayout(const vector<Course>& courses, const function<void(const BinarySearchTree&)>& test) {
+    vector<Course> copy(courses);
+    BinarySearchTree nodes;
+    nodes.BuildBalanced(copy);
+    currentLayout = "nodes";
+    test(nodes);
+
+    BinarySearchTree frozen;
+    frozen.BuildBalanced(copy);
+    frozen.Freeze();
+    currentLayout = "frozen";
+    test(frozen);
+
+    string snapshotFile = (filesystem::temp_directory_path() / "abcu_catalog_tests.snap").string();
+    BinarySearchTree mapped;
+    if (nodes.SaveSnapshot(snapshotFile, snapshotFile)) {
+        mapped.AttachSnapshot(unique_ptr<CatalogSnapshot>(new CatalogSnapshot(snapshotFile)));
+    }
+    currentLayout = "snapshot";
+    CHECK(mapped.Size() == nodes.Size());
+    test(mapped);
+    currentLayout = nullptr;
+    error_code ignored;
+    filesystem::remove(snapshotFile, ignored); // Still mapped - the mapping outlives the name
+}
+
+//===========================//
+// Binary Search Tree Shapes //
+//===========================//
+
+/**
+ * Walks a node-backed tree and checks what every operation has to preserve:
+ * parent links, heights, subtree sizes, key order, the packed keys and (in balanced
+ * mode) AVL balance factors within -1..1
+ */
+class TreeChecker {
+public:
+    static bool Check(const BinarySearchTree& tree) {
+        bool valid = true;
+        const Node* previous = nullptr;
+        checkNode(tree.root, nullptr, tree.balanced, previous, valid);
+        return valid && (tree.root == nullptr || tree.root->parent == nullptr);
+    }
+
+    static size_t PoolBytes(const BinarySearchTree& tree) { return tree.strings.bytesReserved(); }
+
+private:
+    static int checkNode(const Node* node, const Node* parent, bool balanced, const Node*& previous, bool& valid) {
+        if (node == nullptr) {
+            return 0;
+        }
+        if (node->parent != parent) {
+            valid = false;
+        }
+        int leftHeight = checkNode(node->left, node, balanced, previous, valid);
+        if (previous != nullptr && previous->course.courseNumber >= node->course.courseNumber) {
+            valid = false;                      // In-order walk must be strictly ascending
+        }
+        if (comparePacked(node->key, packKey(node->course.courseNumber)) != 0) {
+            valid = false;
+        }
+        previous = node;
+        int rightHeight = checkNode(node->right, node, balanced, previous, valid);
+
+        int leftSize = node->left ? node->left->size : 0;
+        int rightSize = node->right ? node->right->size : 0;
+        if (node->height != 1 + max(leftHeight, rightHeight) || node->size != 1 + leftSize + rightSize) {
+            valid = false;
+        }
+        if (balanced && (leftHeight - rightHeight > 1 || rightHeight - leftHeight > 1)) {
+            valid = false;
+        }
+        return node->height;
+    }
+};
+
+/**
+ * Random inserts, replacements and removals against a set<string> model, checking the
+ * invariants after every operation
+ */
+static void testRandomInsertRemove() {
+    for (bool balanced : { true, false }) {
+        BinarySearchTree tree(balanced);
+        set<string> model;
+        unsigned seed = 2024;
+        bool valid = true;
+        for (int step = 0; step < 3000; step++) {
+            seed = seed * 1103515245 + 12345;
+            string number = courseNumber(static_cast<int>((seed >> 8) % 400));
+            if ((seed >> 20) % 3 == 0) {
+                CHECK(tree.Remove(number) == (model.erase(number) == 1));
+            }
+            else {
+                tree.Insert(makeCourse(number));
+                model.insert(number);
+            }
+            valid = valid && TreeChecker::Check(tree);
+        }
+        CHECK(valid);
+        CHECK(tree.Size() == static_cast<int>(model.size()));
+        CHECK(numbersOf(tree) == vector<string>(model.begin(), model.end()));
+        CHECK(!tree.Remove("NOPE"));
+
+        // Drain the tree completely
+        for (const string& number : model) {
+            valid = tree.Remove(number) && TreeChecker::Check(tree) && valid;
+        }
+        CHECK(valid);
+        CHECK(tree.Size() == 0);
+        CHECK(tree.begin() == tree.end());
+    }
+}
+
+/**
+ * Sorted input is the worst case for a plain BST - the AVL tree must stay logarithmic
+ */
+static void testSortedInsertStaysBalanced() {
+    BinarySearchTree tree;
+    const int COUNT = 4095;
+    for (int key = 0; key < COUNT; key++) {
+        tree.Insert(makeCourse(courseNumber(key)));
+    }
+    CHECK(TreeChecker::Check(tree));
+    CHECK(tree.Size() == COUNT);
+    CHECK(tree.MaxDepth() <= 17);           // AVL bound 1.44 * log2(n + 2)
+
+    BinarySearchTree plain(false);
+    for (int key = 0; key < 100; key++) {
+        plain.Insert(makeCourse(courseNumber(key)));
+    }
+    CHECK(TreeChecker::Check(plain));
+    CHECK(plain.MaxDepth() == 100);         // Unbalanced mode really does degrade to a list
+}
+
+/**
+ * Inserting an existing course number replaces its data without adding a node
+ */
+static void testInsertReplacesAndUpdate() {
+    BinarySearchTree tree;
+    tree.Insert(makeCourse("CS100"));
+    tree.Insert(makeCourse("CS200", { "CS100" }));
+    Course replacement = makeCourse("CS200");
+    replacement.courseName = "Data Structures";
+    tree.Insert(replacement);
+    CHECK(tree.Size() == 2);
+    CHECK(tree.Find("CS200").name() == "Data Structures");
+    CHECK(tree.Find("CS200").prerequisiteCount() == 0);
+
+    string_view prerequisites[] = { "CS100" };
+    CHECK(tree.Update("CS200", "Algorithms", prerequisites, 1));
+    CHECK(!tree.Update("CS999", "Missing", nullptr, 0));
+    CHECK(tree.Find("CS200").name() == "Algorithms");
+    CHECK(tree.Find("CS200").prerequisite(0) == "CS100");
+    CHECK(TreeChecker::Check(tree));
+}
+
+/**
+ * BuildBalanced sorts, keeps the last duplicate and builds a minimum-height tree
+ */
+static void testBuildBalanced() {
+    vector<Course> courses;
+    for (int key = 999; key >= 0; key--) {
+        courses.push_back(makeCourse(courseNumber(key)));
+    }
+    Course duplicate = makeCourse(courseNumber(500));
+    duplicate.courseName = "Last one wins";
+    courses.push_back(duplicate);
+
+    BinarySearchTree tree;
+    tree.Insert(makeCourse("OLD100"));      // Replaced by the build
+    tree.BuildBalanced(courses);
+    CHECK(TreeChecker::Check(tree));
+    CHECK(tree.Size() == 1000);
+    CHECK(tree.MaxDepth() == 10);           // ceil(log2(1001))
+    CHECK(!tree.Contains("OLD100"));
+    CHECK(tree.Find(courseNumber(500)).name() == "Last one wins");
+
+    // Later edits keep the invariants
+    for (int key = 0; key < 1000; key += 3) {
+        tree.Remove(courseNumber(key));
+    }
+    tree.Insert(makeCourse("ZZZ999"));
+    CHECK(TreeChecker::Check(tree));
+    CHECK(tree.Size() == 1000 - 334 + 1);
+
+    vector<Course> none;
+    tree.BuildBalanced(none);
+    CHECK(tree.Size() == 0);
+    CHECK(TreeChecker::Check(tree));
+}
+
+//=================//
+// Rank and Select //
+//=================//
+
+/**
+ * Select(k) walks to the k-th course and Rank() is its inverse, on every layout
+ */
+static void testRankAndSelect() {
+    vector<Course> courses;
+    for (int key = 0; key < 600; key += 2) {
+        courses.push_back(makeCourse(courseNumber(key))); // Odd keys are missing
+    }
+    forEachLayout(courses, [](const BinarySearchTree& tree) {
+        bool consistent = true;
+        size_t position = 0;
+        for (CourseRef course : tree) {
+            consistent = consistent && tree.Select(position).number() == course.number();
+            consistent = consistent && tree.Rank(course.number()) == static_cast<long>(position);
+            position++;
+        }
+        CHECK(consistent);
+        CHECK(position == 300);
+        CHECK(!tree.Select(300));
+        CHECK(tree.Rank(courseNumber(1)) == -1);
+        CHECK(tree.Rank("cs0004") == 2);        // Keys are case-insensitive
+        CHECK(tree.Rank("") == -1);
+        CHECK(tree.Rank("ZZZ") == -1);
+    });
+
+    // Ranks follow inserts and removals on a node tree
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+    tree.Remove(courseNumber(0));
+    tree.Insert(makeCourse(courseNumber(3)));
+    CHECK(tree.Select(0).number() == courseNumber(2));
+    CHECK(tree.Rank(courseNumber(3)) == 1);
+    CHECK(tree.Rank(courseNumber(4)) == 2);
+    CHECK(tree.Select(299).number() == courseNumber(598));
+}
+
+//==================//
+// Course Iterators //
+//==================//
+
+/**
+ * Expected course numbers: every even key from first to last inclusive
+ */
+static vector<string> evenNumbers(int first, int last) {
+    vector<string> numbers;
+    for (int key = first + first % 2; key <= last; key += 2) {
+        numbers.push_back(courseNumber(key));
+    }
+    return numbers;
+}
+
+/**
+ * Forward and backward walks, lower/upper bounds and inclusive ranges
+ */
+static void testIteratorsAndRange() {
+    vector<Course> courses;
+    for (int key = 0; key < 600; key += 2) {
+        courses.push_back(makeCourse(courseNumber(key)));
+    }
+    forEachLayout(courses, [](const BinarySearchTree& tree) {
+        vector<string> backward;
+        for (CourseIterator it = tree.end(); it != tree.begin();) {
+            --it;
+            backward.emplace_back((*it).number());
+        }
+        vector<string> forward = numbersOf(tree);
+        CHECK(vector<string>(backward.rbegin(), backward.rend()) == forward);
+
+        CHECK((*tree.lower_bound(courseNumber(11))).number() == courseNumber(12));
+        CHECK((*tree.upper_bound(courseNumber(12))).number() == courseNumber(14));
+        CHECK(tree.lower_bound("ZZZ") == tree.end());
+
+        CHECK(numbersOf(tree.Range(courseNumber(10), courseNumber(20))) == evenNumbers(10, 20));
+        CHECK(numbersOf(tree.Range(courseNumber(11), courseNumber(21))) == evenNumbers(11, 21));
+        CHECK(numbersOf(tree.Range("cs0010", "cs0020")) == evenNumbers(10, 20)); // Lower-case bounds
+        CHECK(numbersOf(tree.Range(courseNumber(42), courseNumber(42))) == evenNumbers(42, 42));
+        CHECK(numbersOf(tree.Range("", "ZZZ")) == forward);
+
+        // Reversed bounds and ranges that fall between or outside the courses are empty
+        CHECK(tree.Range(courseNumber(20), courseNumber(10)).empty());
+        CHECK(tree.Range("cs0020", "CS0010").empty());
+        CHECK(tree.Range(courseNumber(11), courseNumber(11)).empty());
+        CHECK(tree.Range("ZZZ", "ZZZZ").empty());
+        CHECK(tree.Range("A", "B").empty());
+    });
+}
+
+/**
+ * Prefix scans, including case folding and prefixes that match nothing
+ */
+static void testPrefix() {
+    vector<Course> courses;
+    for (int key = 0; key < 600; key += 2) {
+        courses.push_back(makeCourse(courseNumber(key)));
+    }
+    courses.push_back(makeCourse("MATH201"));
+    courses.push_back(makeCourse("MATH210"));
+    forEachLayout(courses, [](const BinarySearchTree& tree) {
+        CHECK(numbersOf(tree.Prefix("CS001")) == evenNumbers(10, 19));
+        CHECK(numbersOf(tree.Prefix("cs001")) == evenNumbers(10, 19));
+        CHECK(numbersOf(tree.Prefix("MATH2")) == vector<string>({ "MATH201", "MATH210" }));
+        CHECK(numbersOf(tree.Prefix(courseNumber(42))) == evenNumbers(42, 42));
+        CHECK(numbersOf(tree.Prefix("")) == numbersOf(tree));
+
+        CHECK(tree.Prefix("CS9").empty());      // Sorts after every CS course
+        CHECK(tree.Prefix("CS0011").empty());   // Between two courses
+        CHECK(tree.Prefix("BIO").empty());      // Before every course
+        CHECK(tree.Prefix("ZOO").empty());      // After every course
+        CHECK(tree.Prefix("MATH2010").empty()); // Longer than the course number
+    });
+}
+
+//====================//
+// Prerequisite Graph //
+//====================//
+
+/**
+ * Check isRequired/allPrerequisites against a depth-first walk of the course lists
+ * Course i of the DAG requires i - 1 and i / 2, so chains and shared ancestors both occur
+ */
+static void checkPrerequisiteQueries(size_t fillerCourses, bool expectClosure) {
+    const int DAG_COURSES = 60;
+    auto dagNumber = [](int key) { return "DAG" + courseNumber(key); };
+    vector<Course> courses;
+    vector<vector<int>> direct(DAG_COURSES);
+    for (int key = 0; key < DAG_COURSES; key++) {
+        vector<string> prerequisites;
+        if (key > 0) {
+            direct[key] = { key - 1, key / 2 };
+            prerequisites = { dagNumber(key - 1), dagNumber(key / 2) };
+        }
+        courses.push_back(makeCourse(dagNumber(key), prerequisites));
+    }
+    for (size_t filler = 0; filler < fillerCourses; filler++) {
+        courses.push_back(makeCourse("F" + to_string(100000 + filler)));
+    }
+
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+    tree.BuildGraph();
+    const PrerequisiteGraph* graph = tree.Graph();
+    CHECK(graph != nullptr);
+    if (graph == nullptr) {
+        return;
+    }
+    CHECK(graph->hasClosure() == expectClosure);
+    CHECK((graph->closureBytes() > 0) == expectClosure);
+
+    bool allMatch = true;
+    bool pairsMatch = true;
+    for (int key = 0; key < DAG_COURSES; key++) {
+        vector<char> expected(DAG_COURSES, 0);
+        vector<int> stack(direct[key]);
+        while (!stack.empty()) {
+            int next = stack.back();
+            stack.pop_back();
+            if (!expected[next]) {
+                expected[next] = 1;
+                stack.insert(stack.end(), direct[next].begin(), direct[next].end());
+            }
+        }
+        vector<string> expectedChain;
+        for (int other = 0; other < DAG_COURSES; other++) {
+            if (expected[other]) {
+                expectedChain.push_back(dagNumber(other));
+            }
+        }
+
+        uint32_t id = static_cast<uint32_t>(graph->find(dagNumber(key)));
+        vector<string> chain;
+        for (uint32_t prerequisite : graph->allPrerequisites(id)) {
+            chain.emplace_back(graph->number(prerequisite));
+        }
+        vector<string> visited;
+        graph->forEachPrerequisite(id, [&](uint32_t prerequisite) { visited.emplace_back(graph->number(prerequisite)); });
+        allMatch = allMatch && chain == expectedChain && visited == expectedChain
+            && graph->allPrerequisiteCount(id) == expectedChain.size();
+
+        for (int other = 0; other < DAG_COURSES; other++) {
+            uint32_t otherId = static_cast<uint32_t>(graph->find(dagNumber(other)));
+            pairsMatch = pairsMatch && graph->isRequired(id, otherId) == (expected[other] != 0);
+        }
+    }
+    CHECK(allMatch);
+    CHECK(pairsMatch);
+
+    // Filler courses have no prerequisites and nothing requires them
+    uint32_t filler = static_cast<uint32_t>(graph->find("F100000"));
+    CHECK(graph->allPrerequisites(filler).empty());
+    CHECK(!graph->isRequired(static_cast<uint32_t>(graph->find(dagNumber(DAG_COURSES - 1))), filler));
+}
+
+/**
+ * Small catalogs answer from the bitset closure; past CLOSURE_MAX_COURSES the queries
+ * walk the graph instead and must give the same answers
+ */
+static void testPrerequisiteClosure() {
+    checkPrerequisiteQueries(100, true);
+    checkPrerequisiteQueries(PrerequisiteGraph::CLOSURE_MAX_COURSES, false);
+}
+
+/**
+ * Graph with a chain, a three-course cycle, a course blocked by the cycle and a course
+ * that lists itself
+ */
+static vector<Course> cyclicCatalog() {
+    return {
+        makeCourse("A"), makeCourse("B", { "A" }), makeCourse("C", { "B" }), makeCourse("D", { "C", "A" }),
+        makeCourse("X", { "Y" }), makeCourse("Y", { "Z" }), makeCourse("Z", { "X" }),
+        makeCourse("W", { "X" }), makeCourse("S", { "S" })
+    };
+}
+
+/**
+ * Kahn's order places prerequisites first and leaves out everything on or behind a
+ * cycle; Tarjan's pass reports each cycle once
+ */
+static void testCyclesAndTopologicalOrder() {
+    vector<Course> courses = cyclicCatalog();
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+    tree.BuildGraph();
+    const PrerequisiteGraph& graph = *tree.Graph();
+    auto id = [&](string_view number) { return static_cast<uint32_t>(graph.find(number)); };
+
+    CHECK(graph.hasCycles());
+    CHECK(graph.selfReferencingCourses() == vector<uint32_t>({ id("S") }));
+    CHECK(graph.prerequisiteCycles().size() == 2);
+    bool foundSelf = false;
+    bool foundTriangle = false;
+    for (const vector<uint32_t>& cycle : graph.prerequisiteCycles()) {
+        CHECK(cycle.size() >= 2 && cycle.front() == cycle.back()); // Closed walk: A ... A
+        foundSelf = foundSelf || cycle == vector<uint32_t>({ id("S"), id("S") });
+        foundTriangle = foundTriangle || (cycle.size() == 4 && set<uint32_t>(cycle.begin(), cycle.end())
+            == set<uint32_t>({ id("X"), id("Y"), id("Z") }));
+    }
+    CHECK(foundSelf);
+    CHECK(foundTriangle);
+
+    vector<long> position(graph.size(), -1);
+    const vector<uint32_t>& order = graph.topologicalOrder();
+    for (size_t i = 0; i < order.size(); i++) {
+        position[order[i]] = static_cast<long>(i);
+    }
+    for (string_view number : { "A", "B", "C", "D" }) {
+        CHECK(position[id(number)] >= 0);
+    }
+    for (string_view number : { "W", "X", "Y", "Z" }) {
+        CHECK(position[id(number)] == -1);
+    }
+    CHECK(position[id("A")] < position[id("B")]);
+    CHECK(position[id("B")] < position[id("C")]);
+    CHECK(position[id("C")] < position[id("D")]);
+
+    // Acyclic catalogs have no cycles and every course in the order
+    vector<Course> chain = { makeCourse("A"), makeCourse("B", { "A" }), makeCourse("C", { "A", "B" }) };
+    BinarySearchTree acyclic;
+    acyclic.BuildBalanced(chain);
+    acyclic.BuildGraph();
+    CHECK(!acyclic.Graph()->hasCycles());
+    CHECK(acyclic.Graph()->topologicalOrder() == vector<uint32_t>({ 0, 1, 2 }));
+}
+
+/**
+ * The planner only offers courses whose prerequisites are done, keeps to the semester
+ * limit and reports courses on or behind a cycle as unschedulable
+ */
+static void testSemesterPlanner() {
+    vector<Course> courses = cyclicCatalog();
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+    tree.BuildGraph();
+    const PrerequisiteGraph& graph = *tree.Graph();
+    auto id = [&](string_view number) { return static_cast<uint32_t>(graph.find(number)); };
+
+    SemesterPlanner planner(graph);
+    planner.reset();
+    planner.complete(id("A"));
+    vector<uint32_t> available;
+    planner.available(available);
+    CHECK(available == vector<uint32_t>({ id("B") }));
+    CHECK(planner.isCompleted(id("A")));
+    CHECK(!planner.isAvailable(id("C")));
+
+    vector<uint32_t> plan;
+    vector<uint32_t> semesterStarts;
+    CHECK(planner.plan(plan, semesterStarts) == 5); // S, W, X, Y and Z can never be taken
+    CHECK(plan == vector<uint32_t>({ id("B"), id("C"), id("D") }));
+    CHECK(semesterStarts == vector<uint32_t>({ 0, 1, 2, 3 }));
+
+    // Random DAG: every prerequisite lands in an earlier semester, at most 3 per semester
+    vector<Course> dag;
+    unsigned seed = 99;
+    for (int key = 0; key < 200; key++) {
+        vector<string> prerequisites;
+        for (int edge = 0; edge < 3 && key > 0; edge++) {
+            seed = seed * 1103515245 + 12345;
+            prerequisites.push_back(courseNumber(static_cast<int>((seed >> 8) % key)));
+        }
+        dag.push_back(makeCourse(courseNumber(key), prerequisites));
+    }
+    BinarySearchTree dagTree;
+    dagTree.BuildBalanced(dag);
+    dagTree.BuildGraph();
+    const PrerequisiteGraph& dagGraph = *dagTree.Graph();
+    SemesterPlanner dagPlanner(dagGraph);
+    dagPlanner.reset();
+    for (uint32_t course = 0; course < 20; course++) {
+        dagPlanner.complete(course);
+    }
+    CHECK(dagPlanner.plan(plan, semesterStarts, 3) == 0);
+    CHECK(plan.size() == 180);
+    vector<long> semester(dagGraph.size(), -1);     // -1 = completed before planning
+    bool limitKept = true;
+    for (size_t s = 0; s + 1 < semesterStarts.size(); s++) {
+        limitKept = limitKept && semesterStarts[s + 1] - semesterStarts[s] <= 3;
+        for (uint32_t i = semesterStarts[s]; i < semesterStarts[s + 1]; i++) {
+            semester[plan[i]] = static_cast<long>(s);
+        }
+    }
+    bool orderKept = true;
+    for (uint32_t course : plan) {
+        for (size_t i = 0; i < dagGraph.prerequisiteCount(course); i++) {
+            orderKept = orderKept && semester[dagGraph.prerequisites(course)[i]] < semester[course];
+        }
+    }
+    CHECK(limitKept);
+    CHECK(orderKept);
+}
+
+//====================//
+// Course Name Search //
+//====================//
+
+/**
+ * Course numbers of name search results, best first
+ */
+static vector<string> searchNumbers(const BinarySearchTree& tree, string_view query, size_t limit = 10) {
+    vector<string> numbers;
+    for (const NameMatch& match : tree.SearchNames(query, limit)) {
+        numbers.emplace_back(tree.Select(match.course).number());
+    }
+    return numbers;
+}
+
+/**
+ * Whole words beat prefixes, prefixes beat typos, every term has to match and ties go to
+ * the course that sorts first
+ */
+static void testNameSearch() {
+    auto named = [](const string& number, const string& name) {
+        Course course = makeCourse(number);
+        course.courseName = name;
+        return course;
+    };
+    vector<Course> courses = {
+        named("CS100", "Introduction to Programming"), named("CS200", "Data Structures"),
+        named("CS300", "Algorithms"), named("CS310", "Operating Systems"), named("CS320", "Computer Networks"),
+        named("CS330", "Data Mining"), named("CS400", "Advanced Algorithms"), named("MATH201", "Discrete Mathematics")
+    };
+
+    for (bool freeze : { false, true }) {
+        currentLayout = freeze ? "frozen" : "nodes";
+        BinarySearchTree tree;
+        tree.BuildBalanced(courses);
+        if (freeze) {
+            tree.Freeze();
+        }
+        CHECK(!tree.HasNameIndex());
+        CHECK(tree.SearchNames("data").empty());  // No index, no results
+        tree.BuildNameIndex();
+        CHECK(tree.HasNameIndex());
+
+        CHECK(searchNumbers(tree, "structures") == vector<string>({ "CS200" }));
+        CHECK(searchNumbers(tree, "DATA STRUCT") == vector<string>({ "CS200" }));
+        CHECK(searchNumbers(tree, "intro prog") == vector<string>({ "CS100" }));
+        CHECK(searchNumbers(tree, "data") == vector<string>({ "CS200", "CS330" }));
+        CHECK(searchNumbers(tree, "data", 1) == vector<string>({ "CS200" }));
+        CHECK(searchNumbers(tree, "algo") == vector<string>({ "CS300", "CS400" }));
+        CHECK(searchNumbers(tree, "advanced algorithms") == vector<string>({ "CS400" }));
+        CHECK(searchNumbers(tree, "algoritms") == vector<string>({ "CS300", "CS400" })); // One typo
+        CHECK(searchNumbers(tree, "strucutres") == vector<string>({ "CS200" }));        // Transposition
+        CHECK(searchNumbers(tree, "zzzz").empty());
+        CHECK(searchNumbers(tree, "").empty());
+        CHECK(searchNumbers(tree, "data zzzz").empty());
+
+        vector<NameMatch> exact = tree.SearchNames("network");
+        vector<NameMatch> typo = tree.SearchNames("netwrok");
+        CHECK(exact.size() == 1 && typo.size() == 1 && exact[0].score > typo[0].score);
+    }
+    currentLayout = nullptr;
+
+    // Edits make the index stale, so it is dropped
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+    tree.BuildNameIndex();
+    tree.Insert(named("CS500", "Data Visualization"));
+    CHECK(!tree.HasNameIndex());
+    tree.BuildNameIndex();
+    CHECK(searchNumbers(tree, "data") == vector<string>({ "CS200", "CS330", "CS500" }));
+}
+
+//=================//
+// Batched Lookups //
+//=================//
+
+/**
+ * True if FindMany returns, key for key, what Find returns
+ */
+static bool findManyMatchesFind(const BinarySearchTree& tree, const vector<string>& keys) {
+    vector<string_view> views(keys.begin(), keys.end());
+    vector<CourseRef> found = tree.FindMany(views.data(), views.size());
+    if (found.size() != keys.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < keys.size(); i++) {
+        CourseRef single = tree.Find(keys[i]);
+        if (static_cast<bool>(found[i]) != static_cast<bool>(single) || (single && found[i].number() != single.number())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * FindMany answers in input order with hits, misses, repeats and lower-case keys mixed
+ */
+static void testFindMany() {
+    vector<Course> courses;
+    for (int key = 0; key < 2000; key += 2) {
+        courses.push_back(makeCourse(courseNumber(key)));
+    }
+    forEachLayout(courses, [](const BinarySearchTree& tree) {
+        vector<string> keys;
+        unsigned seed = 7;
+        for (int i = 0; i < 1000; i++) {
+            seed = seed * 1103515245 + 12345;
+            string key = courseNumber(static_cast<int>((seed >> 8) % 2100)); // Odd and high keys miss
+            if (i % 7 == 0) {
+                transform(key.begin(), key.end(), key.begin(), ::tolower);
+            }
+            keys.push_back(key);
+        }
+        keys.push_back(keys.front());          // Repeated key
+        keys.push_back("");
+        CHECK(findManyMatchesFind(tree, keys));
+
+        vector<string> sorted(keys);
+        sort(sorted.begin(), sorted.end());
+        CHECK(findManyMatchesFind(tree, sorted));
+
+        CHECK(tree.FindMany(nullptr, 0).empty());
+        string_view one[] = { "cs0010" };
+        vector<CourseRef> found = tree.FindMany(one, 1);
+        CHECK(found.size() == 1 && found[0] && found[0].number() == "CS0010");
+    });
+}
+
+/**
+ * Batches whose sorted keys run past the last course - the batch walk must stop cleanly
+ * at the end of the tree and still report the keys before it
+ */
+static void testFindManyPastLastCourse() {
+    vector<Course> courses = { makeCourse("CS100"), makeCourse("CS200"), makeCourse("CS300") };
+    forEachLayout(courses, [](const BinarySearchTree& tree) {
+        string_view batch[] = { "CS200", "CS300", "ZZZ" };
+        vector<CourseRef> found = tree.FindMany(batch, 3);
+        CHECK(found.size() == 3);
+        CHECK(found.size() == 3 && found[0] && found[0].number() == "CS200");
+        CHECK(found.size() == 3 && found[1] && found[1].number() == "CS300");
+        CHECK(found.size() == 3 && !found[2]);
+
+        CHECK(findManyMatchesFind(tree, { "ZZZ", "CS300", "CS301", "ZZZ", "CS100" }));
+        CHECK(findManyMatchesFind(tree, { "CS301", "CS400", "ZZZ" }));   // Every key past the end
+        CHECK(findManyMatchesFind(tree, { "A", "CS100", "ZZZ" }));
+    });
+}
+
+/**
+ * Course numbers longer than a packed key's 16 bytes tie on the packed part and have to
+ * be ordered by the rest of the string
+ */
+static void testLongCourseNumbers() {
+    vector<Course> courses;
+    vector<string> numbers;
+    for (string suffix : { "", "A", "B", "AA", "Z" }) {
+        numbers.push_back("INTERDISCIPLINARY" + suffix);       // 17+ bytes, same first 16
+    }
+    numbers.push_back("INTERDISCIPLINAR");                     // Exactly 16 bytes
+    numbers.push_back("INTERDISCIPLINAQZZZ");
+    for (const string& number : numbers) {
+        courses.push_back(makeCourse(number));
+    }
+    sort(numbers.begin(), numbers.end());
+
+    forEachLayout(courses, [&](const BinarySearchTree& tree) {
+        CHECK(numbersOf(tree) == numbers);
+        bool found = true;
+        for (size_t i = 0; i < numbers.size(); i++) {
+            found = found && tree.Find(numbers[i]).number() == numbers[i] && tree.Rank(numbers[i]) == static_cast<long>(i);
+        }
+        CHECK(found);
+        CHECK(!tree.Find("INTERDISCIPLINARYAB"));
+        CHECK(!tree.Find("INTERDISCIPLINARX"));
+        CHECK(findManyMatchesFind(tree, { "INTERDISCIPLINARYB", "interdisciplinary", "INTERDISCIPLINARYC" }));
+        CHECK(numbersOf(tree.Prefix("INTERDISCIPLINARY")).size() == 5);
+    });
+
+    // Node trees keep the AVL invariants with these keys too
+    BinarySearchTree tree;
+    for (const Course& course : courses) {
+        tree.Insert(course);
+    }
+    CHECK(TreeChecker::Check(tree));
+    CHECK(tree.Remove("INTERDISCIPLINARYA"));
+    CHECK(TreeChecker::Check(tree));
+    CHECK(!tree.Contains("INTERDISCIPLINARYA"));
+}
+
+//==========================//
+// Incremental Catalog Load //
+//==========================//
+
+/**
+ * Sends cout to a string for its lifetime - keeps loader progress out of the test log
+ */
+class QuietOutput {
+private:
+    ostringstream sink;
+    streambuf* saved;
+
+public:
+    QuietOutput() : saved(cout.rdbuf(sink.rdbuf())) {}
+    ~QuietOutput() { cout.rdbuf(saved); }
+};
+
+/**
+ * Write a scratch catalog file and return its path
+ */
+static string writeCatalogFile(const string& name, const string& text) {
+    string path = (filesystem::temp_directory_path() / name).string();
+    ofstream out(path, ios::binary);
+    out << text;
+    return path;
+}
+
+/**
+ * Every course as "NUMBER|Name|PRE,PRE" in order - two trees match if these do
+ */
+static vector<string> contentsOf(const BinarySearchTree& tree) {
+    vector<string> lines;
+    for (CourseRef course : tree) {
+        string line = string(course.number()) + "|" + string(course.name()) + "|";
+        for (size_t i = 0; i < course.prerequisiteCount(); i++) {
+            line += string(i > 0 ? "," : "") + string(course.prerequisite(i));
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+/**
+ * Catalog text for reload tests. Version 1 and 2 differ by removed, renamed and added
+ * courses and changed prerequisites, and include the cases the loader has to settle:
+ * a repeated course number (last valid line wins), an unknown prerequisite, a course
+ * whose prerequisite is removed, and lower-case keys. Renamed courses carry the edit
+ * number, so every reload leaves strings behind in the pool.
+ */
+static string reloadCatalogText(int version, int edit = 0) {
+    string text;
+    for (int key = 0; key < 300; key++) {
+        if (version == 2 && key % 10 == 3) {
+            continue;                                             // Removed courses
+        }
+        string name = "Course " + to_string(key);
+        if (version == 2 && key % 10 == 5) {
+            name = "Renamed " + to_string(key) + " in edit " + to_string(edit);
+        }
+        text += courseNumber(key) + "," + name;
+        if (key > 0) {
+            text += "," + courseNumber(key - 1);                  // Every 10th course loses its prerequisite in v2
+        }
+        if (version == 2 && key % 10 == 7 && key > 20) {
+            text += "," + courseNumber(key - 20);                 // Added prerequisite
+        }
+        text += "\n";
+    }
+    text += "cs9000,Lower Case Key,cs0001\n";
+    text += "CS9001,Needs Unknown,NOPE100\n";                    // Skipped until NOPE100 exists
+    text += "CS9002,First Line\n";
+    text += "CS9002,Repeated Line,CS9000\n";                     // Replaces the line above
+    if (version == 2) {
+        text += "NOPE100,Now Exists\n";
+        text += "CS9500,Added Course,CS0299\n";
+    }
+    return text;
+}
+
+/**
+ * Reloading a changed file must give exactly what a full load of that file gives -
+ * contents, tree shape invariants and graph - in both directions and after many reloads;
+ * dead strings are compacted away so the pool does not grow without bound
+ */
+static void testReloadMatchesFullLoad() {
+    auto load = [](const string& path, BinarySearchTree& tree) {
+        QuietOutput quiet;
+        loadCourses(path, &tree);
+    };
+    auto reload = [](const string& path, BinarySearchTree& tree) {
+        QuietOutput quiet;
+        return reloadCourses(path, &tree);
+    };
+
+    string path = writeCatalogFile("abcu_reload.csv", reloadCatalogText(1));
+    BinarySearchTree reloaded;
+    load(path, reloaded);
+    reloaded.Freeze();
+    CHECK(!reloaded.Contains("CS9001"));
+    CHECK(reloaded.Find("CS9002").name() == "Repeated Line");
+    CHECK(reloaded.Contains("CS9000"));
+
+    size_t largestFreshPool = 0;
+    size_t largestPool = 0;
+    bool matches = true;
+    bool graphsMatch = true;
+    for (int edit = 1; edit <= 100; edit++) {
+        int version = edit % 2 == 1 ? 2 : 1;
+        writeCatalogFile("abcu_reload.csv", reloadCatalogText(version, edit));
+        BinarySearchTree expected;
+        load(path, expected);
+        expected.Freeze();
+        if (edit == 1) {
+            CHECK(expected.Contains("CS9001"));   // Its prerequisite arrived
+            CHECK(!expected.Contains(courseNumber(4))); // Its prerequisite was removed
+        }
+
+        CHECK(reload(path, reloaded));
+        matches = matches && contentsOf(reloaded) == contentsOf(expected) && TreeChecker::Check(reloaded);
+        reloaded.Freeze();
+        matches = matches && contentsOf(reloaded) == contentsOf(expected);
+
+        const PrerequisiteGraph* graph = reloaded.Graph();
+        const PrerequisiteGraph* expectedGraph = expected.Graph();
+        graphsMatch = graphsMatch && graph != nullptr && expectedGraph != nullptr
+            && graph->size() == expectedGraph->size()
+            && graph->topologicalOrder() == expectedGraph->topologicalOrder();
+        largestFreshPool = max(largestFreshPool, TreeChecker::PoolBytes(expected));
+        largestPool = max(largestPool, TreeChecker::PoolBytes(reloaded));
+    }
+    CHECK(matches);
+    CHECK(graphsMatch);
+    CHECK(largestPool <= 2 * largestFreshPool); // Compaction keeps dead strings below half the pool
+
+    // Reloading an unchanged file changes nothing; a missing file leaves the tree alone
+    vector<string> before = contentsOf(reloaded);
+    CHECK(reload(path, reloaded));
+    CHECK(contentsOf(reloaded) == before);
+    CHECK(!reload(path + ".missing", reloaded));
+    CHECK(contentsOf(reloaded) == before);
+
+    error_code ignored;
+    filesystem::remove(path, ignored);
+}
+
+//=============================//
+// Persistent Catalog Versions //
+//=============================//
+
+/**
+ * Course numbers of a version, in visiting order
+ */
+static vector<string> numbersOf(const CatalogVersion& version) {
+    vector<string> numbers;
+    version.ForEach([&](const Course& course) { numbers.push_back(course.courseNumber); });
+    return numbers;
+}
+
+/**
+ * Every edit returns a new version and leaves the old one exactly as it was; versions
+ * share all nodes off the edited path
+ */
+static void testCatalogVersions() {
+    vector<Course> courses;
+    for (int key = 0; key < 1000; key++) {
+        courses.push_back(makeCourse(courseNumber(key)));
+    }
+    BinarySearchTree tree;
+    tree.BuildBalanced(courses);
+
+    CatalogVersion added;
+    CatalogVersion removed;
+    {
+        CatalogVersion base = CatalogVersion::FromTree(tree);
+        CHECK(base.Size() == 1000);
+        CHECK(numbersOf(base) == numbersOf(tree));
+        CHECK(base.Find("cs0010") != nullptr && base.Find("cs0010")->courseNumber == "CS0010");
+        CHECK(base.Find("CS5000") == nullptr);
+
+        added = base.Insert(makeCourse("CS5000", { "CS0001" }));
+        removed = added.Remove("CS0500");
+        Course replacement = makeCourse("CS0010");
+        replacement.courseName = "Replaced";
+        CatalogVersion replaced = base.Insert(replacement);
+
+        CHECK(base.Size() == 1000 && base.Find("CS5000") == nullptr);      // Base is untouched
+        CHECK(base.Find("CS0010")->courseName == "Course CS0010");
+        CHECK(added.Size() == 1001 && added.Find("CS5000") != nullptr);
+        CHECK(added.Find("CS0500") != nullptr);
+        CHECK(removed.Size() == 1000 && removed.Find("CS0500") == nullptr);
+        CHECK(replaced.Size() == 1000 && replaced.Find("CS0010")->courseName == "Replaced");
+
+        // Path copying: one edit adds at most a root-to-leaf path of new nodes
+        size_t shared = CatalogVersion::DistinctNodes({ base, added });
+        CHECK(shared > 1001 && shared <= 1001 + static_cast<size_t>(2 * added.Height()));
+        CHECK(CatalogVersion::DistinctNodes({ base, base.Remove("NOPE") }) == 1000);
+    }
+
+    // The newer versions outlive the base they were made from
+    vector<string> expected = numbersOf(tree);
+    expected.push_back("CS5000");
+    CHECK(numbersOf(added) == expected);
+    expected.erase(find(expected.begin(), expected.end(), "CS0500"));
+    CHECK(numbersOf(removed) == expected);
+
+    unique_ptr<BinarySearchTree> materialized(removed.Materialize());
+    CHECK(numbersOf(*materialized) == expected);
+    CHECK(TreeChecker::Check(*materialized));
+    CHECK(materialized->Find("CS5000").prerequisite(0) == "CS0001");
+}
+
+/**
+ * Random edits keep the version balanced and in step with a set<string> model
+ */
+static void testCatalogVersionBalance() {
+    CatalogVersion version;
+    vector<CatalogVersion> history;
+    set<string> model;
+    unsigned seed = 31;
+    for (int step = 0; step < 3000; step++) {
+        seed = seed * 1103515245 + 12345;
+        string number = courseNumber(static_cast<int>((seed >> 8) % 1500));
+        if ((seed >> 20) % 4 == 0) {
+            version = version.Remove(number);
+            model.erase(number);
+        }
+        else {
+            version = version.Insert(makeCourse(number));
+            model.insert(number);
+        }
+        if (step % 500 == 0) {
+            history.push_back(version);
+        }
+    }
+    CHECK(version.Size() == model.size());
+    CHECK(numbersOf(version) == vector<string>(model.begin(), model.end()));
+    CHECK(version.Height() <= 16);           // AVL bound for about 1100 courses
+    CHECK(CatalogVersion::DistinctNodes(history) < history.size() * version.Size());
+}
+
+//===============//
+// Main Function //
+//===============//
+
+int main() {
+    const TestCase tests[] = {
+        { "AVL invariants under random inserts and removals", testRandomInsertRemove },
+        { "Sorted inserts stay balanced", testSortedInsertStaysBalanced },
+        { "Insert replaces, Update edits in place", testInsertReplacesAndUpdate },
+        { "BuildBalanced", testBuildBalanced },
+        { "Rank and Select", testRankAndSelect },
+        { "Iterators and Range", testIteratorsAndRange },
+        { "Prefix", testPrefix },
+        { "Prerequisite closure and graph walk", testPrerequisiteClosure },
+        { "Cycles and topological order", testCyclesAndTopologicalOrder },
+        { "Semester planner", testSemesterPlanner },
+        { "Course name search", testNameSearch },
+        { "FindMany matches Find", testFindMany },
+        { "Incremental reload matches a full load", testReloadMatchesFullLoad },
+        { "FindMany with keys past the last course", testFindManyPastLastCourse },
+        { "Course numbers longer than a packed key", testLongCourseNumbers },
+        { "Persistent catalog versions", testCatalogVersions },
+        { "Catalog versions stay balanced", testCatalogVersionBalance },
+    };
+
+    for (const TestCase& test : tests) {
+        int failuresBefore = failureCount;
+        test.run();
+        cout << (failureCount == failuresBefore ? "[ OK ] " : "[FAIL] ") << test.name << endl;
+    }
+    cout << checkCount << " checks, " << failureCount << " failed" << endl;
+    return failureCount == 0 ? 0 : 1;
+}
\ No newline at end of file